@@ -0,0 +1,407 @@
+// NOLINTNEXTLINE(bugprone-reserved-identifier,cert-dcl37-c)
+#define _POSIX_C_SOURCE 199309L
+
+#include "engine.c"
+#include "engine.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MIN_BENCH_TIME_NS 50000000U
+#define MAX_MAP_SIZE 4096U
+#define BENCH_SEED 0x12345678U
+#define MAX_SHADOWCAST_AGENTS 10000U
+#define NS_PER_SECOND 1000000000ULL
+
+enum ActionMix : uint32_t
+{
+    MIX_NONE,
+    MIX_TURN,
+    MIX_MOVE,
+    MIX_DOOR,
+    MIX_ALL,
+};
+
+static const char *const MIX_NAMES[] = {"none", "turn", "move", "door", "all"};
+
+static const uint32_t MAP_SIZES[] = {16U, 64U, 256U, 1024U, 4096U};
+static const uint32_t AGENT_COUNTS[] = {1U, 100U, 1000U, 10000U, 100000U};
+
+struct Bench
+{
+    uint32_t n_rows;
+    uint32_t n_cols;
+    uint32_t n_agents;
+    uint32_t *world_state;
+    uint32_t *agent_states;
+    uint32_t *agent_actions;
+    uint64_t *scratch;       // observation cache
+    uint32_t *shadow_states; // NULL for more than `MAX_SHADOWCAST_AGENTS`
+};
+
+// prevents the compiler from discarding benchmarked results
+static volatile uint32_t g_sink;
+
+static uint32_t g_n_threads = 1U;
+
+// NOLINTBEGIN(readability-magic-numbers)
+[[nodiscard]] static uint32_t next_random(uint64_t *state)
+{
+    // splitmix64
+    *state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = *state; // NOLINT(readability-identifier-length)
+    z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+    return (uint32_t)((z ^ (z >> 31U)) >> 32U);
+}
+// NOLINTEND(readability-magic-numbers)
+
+[[nodiscard]] static uint64_t now_ns(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((uint64_t)time.tv_sec * NS_PER_SECOND) + (uint64_t)time.tv_nsec;
+}
+
+// NOLINTBEGIN(readability-magic-numbers)
+[[nodiscard]] static enum Tile random_tile(uint64_t *random)
+{
+    const uint32_t roll = next_random(random) % 100U;
+    if (roll < 10U)
+    {
+        return TILE_WALL;
+    }
+    if (roll < 12U)
+    {
+        return TILE_CLOSED_DOOR;
+    }
+    if (roll < 14U)
+    {
+        return TILE_OPEN_DOOR;
+    }
+    return TILE_FLOOR;
+}
+// NOLINTEND(readability-magic-numbers)
+
+// returns false if a buffer of `bench` cannot be allocated
+[[nodiscard]] static bool create_bench(struct Bench *bench, uint64_t *random)
+{
+    const uint32_t n_agents = bench->n_agents;
+    const size_t n_tiles = (size_t)bench->n_rows * bench->n_cols;
+    const size_t n_words = 3U + (2U * (size_t)n_agents)
+        + ((n_tiles + sizeof(uint32_t) - 1U) / sizeof(uint32_t));
+
+    bench->world_state = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    bench->agent_states = (uint32_t *)calloc(
+        (size_t)n_agents * AGENT_STATE_SIZE, sizeof(uint32_t));
+    bench->agent_actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+    if (bench->world_state == NULL || bench->agent_states == NULL
+        || bench->agent_actions == NULL)
+    {
+        return false;
+    }
+
+    uint32_t *world_state = bench->world_state;
+    world_state[0] = n_agents;
+    world_state[1U + (2U * n_agents)] = bench->n_rows;
+    world_state[2U + (2U * n_agents)] = bench->n_cols;
+
+    enum Tile *tiles = (enum Tile *)(world_state + 3U + (2U * n_agents));
+    for (size_t i = 0; i < n_tiles; i++)
+    {
+        tiles[i] = random_tile(random);
+    }
+
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        uint32_t pos = next_random(random) % (uint32_t)n_tiles;
+        while (tiles[pos] != TILE_FLOOR)
+        {
+            pos = (pos + 1U) % (uint32_t)n_tiles;
+        }
+
+        tiles[pos] = TILE_FLOOR_OCCUPIED;
+        world_state[1U + i] = pos;
+        world_state[1U + n_agents + i] = next_random(random) % 4U;
+    }
+
+    const size_t n_scratch =
+        scratch_size(world_state, SCRATCH_OBSERVATION_CACHE);
+    bench->scratch = (uint64_t *)calloc(n_scratch, sizeof(uint64_t));
+    if (bench->scratch == NULL)
+    {
+        return false;
+    }
+    init_scratch(world_state, bench->scratch, SCRATCH_OBSERVATION_CACHE);
+
+    if (n_agents <= MAX_SHADOWCAST_AGENTS)
+    {
+        bench->shadow_states = (uint32_t *)calloc(
+            (size_t)n_agents * shadowcast_state_size(SHADOWCAST_MAX_RADIUS),
+            sizeof(uint32_t));
+        if (bench->shadow_states == NULL)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void destroy_bench(struct Bench *bench)
+{
+    free(bench->shadow_states);
+    free(bench->scratch);
+    free(bench->agent_actions);
+    free(bench->agent_states);
+    free(bench->world_state);
+}
+
+static void set_actions(const struct Bench *bench,
+                        const enum ActionMix mix,
+                        uint64_t *random)
+{
+    for (uint32_t i = 0; i < bench->n_agents; i++)
+    {
+        const uint32_t roll = next_random(random);
+        switch (mix)
+        {
+        case MIX_NONE:
+            bench->agent_actions[i] = ACTION_NONE;
+            break;
+        case MIX_TURN:
+            bench->agent_actions[i] = ACTION_TURN_90 + (roll % 3U);
+            break;
+        case MIX_MOVE:
+            bench->agent_actions[i] = ACTION_MOVE_UP + (roll % 4U);
+            break;
+        case MIX_DOOR:
+            bench->agent_actions[i] = ACTION_OPEN_DOOR + (roll % 2U);
+            break;
+        case MIX_ALL:
+            bench->agent_actions[i] = roll % (ACTION_CLOSE_DOOR + 1U);
+            break;
+        }
+    }
+}
+
+static void run_tick(const struct Bench *bench, const uint32_t iteration)
+{
+    tick(bench->world_state,
+         bench->agent_states,
+         bench->agent_actions,
+         iteration + 1U);
+    g_sink = bench->agent_states[AGENT_STATE_SIZE - 1U];
+}
+
+static void run_tick_with_observation_cache(const struct Bench *bench,
+                                            const uint32_t iteration)
+{
+    tick_with_scratch(bench->world_state,
+                      bench->scratch,
+                      bench->agent_states,
+                      bench->agent_actions,
+                      iteration + 1U);
+    g_sink = bench->agent_states[AGENT_STATE_SIZE - 1U];
+}
+
+static void run_fill_agent_fov(const struct Bench *bench,
+                               const uint32_t iteration)
+{
+    const struct World world = load_world(bench->world_state, iteration);
+
+    uint32_t checksum = 0U;
+    for (uint32_t i = 0; i < bench->n_agents; i++)
+    {
+        enum Tile tiles[FOV_SIZE * FOV_SIZE];
+        fill_agent_fov(&world, i, tiles);
+        checksum += tiles[0];
+    }
+    g_sink = checksum;
+}
+
+// stores the FoVs of all agents without occlusion in their agent states
+static void fill_agent_fovs(const struct Bench *bench)
+{
+    const struct World world = load_world(bench->world_state, 0U);
+
+    for (uint32_t i = 0; i < bench->n_agents; i++)
+    {
+        uint32_t *agent_state =
+            bench->agent_states + ((size_t)i * AGENT_STATE_SIZE);
+        fill_agent_fov(&world, i, (enum Tile *)(agent_state + 4U));
+    }
+}
+
+static void run_apply_occlusion(const struct Bench *bench,
+                                const uint32_t iteration)
+{
+    (void)iteration;
+
+    uint32_t checksum = 0U;
+    for (uint32_t i = 0; i < bench->n_agents; i++)
+    {
+        enum Tile tiles[FOV_SIZE * FOV_SIZE];
+        memcpy(tiles,
+               bench->agent_states + ((size_t)i * AGENT_STATE_SIZE) + 4U,
+               sizeof(tiles));
+        apply_occlusion(tiles);
+        checksum += tiles[0];
+    }
+    g_sink = checksum;
+}
+
+static void run_try_realize_action(const struct Bench *bench,
+                                   const uint32_t iteration)
+{
+    const struct World world = load_world(bench->world_state, iteration);
+
+    for (uint32_t i = 0; i < bench->n_agents; i++)
+    {
+        try_realize_action(&world, bench->agent_actions[i], i);
+    }
+    g_sink = world.agents.positions[0];
+}
+
+static void run_observe_shadowcast(const struct Bench *bench,
+                                   const uint32_t radius)
+{
+    observe_shadowcast(bench->world_state, radius, bench->shadow_states);
+    g_sink = bench->shadow_states[shadowcast_state_size(radius) - 1U];
+}
+
+static void run_observe_shadowcast_15(const struct Bench *bench,
+                                      const uint32_t iteration)
+{
+    (void)iteration;
+    run_observe_shadowcast(bench, 15U); // NOLINT(readability-magic-numbers)
+}
+
+static void run_observe_shadowcast_30(const struct Bench *bench,
+                                      const uint32_t iteration)
+{
+    (void)iteration;
+    run_observe_shadowcast(bench, 30U); // NOLINT(readability-magic-numbers)
+}
+
+static void report(const char *name,
+                   const struct Bench *bench,
+                   const enum ActionMix mix,
+                   void (*run)(const struct Bench *, uint32_t))
+{
+    uint32_t n_iterations = 1U;
+    uint64_t elapsed = 0U;
+    while (true)
+    {
+        const uint64_t start = now_ns();
+        for (uint32_t i = 0; i < n_iterations; i++)
+        {
+            run(bench, i);
+        }
+        elapsed = now_ns() - start;
+
+        if (elapsed >= MIN_BENCH_TIME_NS)
+        {
+            break;
+        }
+        n_iterations *= 2U;
+    }
+
+    const double n_steps = (double)n_iterations * (double)bench->n_agents;
+    printf("{\"benchmark\": \"%s\", \"rows\": %u, \"cols\": %u, "
+           "\"agents\": %u, \"actions\": \"%s\", \"threads\": %u, "
+           "\"iterations\": %u, \"ns_per_agent_step\": %.3f}\n",
+           name,
+           bench->n_rows,
+           bench->n_cols,
+           bench->n_agents,
+           MIX_NAMES[mix],
+           g_n_threads,
+           n_iterations,
+           (double)elapsed / n_steps);
+    (void)fflush(stdout);
+}
+
+[[nodiscard]] static uint32_t parse_count(const char *arg)
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    return (uint32_t)strtoul(arg, NULL, 10);
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t max_map_size =
+        (argc > 1) ? parse_count(argv[1]) : MAX_MAP_SIZE;
+    if (argc > 2)
+    {
+        g_n_threads = set_thread_count(parse_count(argv[2]));
+    }
+
+    uint64_t random = BENCH_SEED;
+    for (size_t i = 0; i < sizeof(MAP_SIZES) / sizeof(MAP_SIZES[0]); i++)
+    {
+        if (MAP_SIZES[i] > max_map_size)
+        {
+            continue;
+        }
+
+        for (size_t j = 0; j < sizeof(AGENT_COUNTS) / sizeof(AGENT_COUNTS[0]);
+             j++)
+        {
+            // keep at least half of the map free
+            const uint32_t n_tiles = MAP_SIZES[i] * MAP_SIZES[i];
+            if (AGENT_COUNTS[j] > n_tiles / 2U)
+            {
+                continue;
+            }
+
+            struct Bench bench = {.n_rows = MAP_SIZES[i],
+                                  .n_cols = MAP_SIZES[i],
+                                  .n_agents = AGENT_COUNTS[j]};
+            if (!create_bench(&bench, &random))
+            {
+                destroy_bench(&bench);
+                (void)fprintf(stderr, "out of memory\n");
+                return EXIT_FAILURE;
+            }
+
+            for (uint32_t mix = MIX_NONE; mix <= MIX_ALL; mix++)
+            {
+                set_actions(&bench, (enum ActionMix)mix, &random);
+                report("tick", &bench, (enum ActionMix)mix, run_tick);
+                report("tick_with_observation_cache",
+                       &bench,
+                       (enum ActionMix)mix,
+                       run_tick_with_observation_cache);
+                report("try_realize_action",
+                       &bench,
+                       (enum ActionMix)mix,
+                       run_try_realize_action);
+            }
+
+            report("fill_agent_fov", &bench, MIX_NONE, run_fill_agent_fov);
+
+            fill_agent_fovs(&bench);
+            report("apply_occlusion", &bench, MIX_NONE, run_apply_occlusion);
+
+            if (bench.shadow_states != NULL)
+            {
+                report("observe_shadowcast_15",
+                       &bench,
+                       MIX_NONE,
+                       run_observe_shadowcast_15);
+                report("observe_shadowcast_30",
+                       &bench,
+                       MIX_NONE,
+                       run_observe_shadowcast_30);
+            }
+
+            destroy_bench(&bench);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
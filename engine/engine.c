@@ -1,6 +1,21 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "engine.h"
+
+// rules of FoV sizes other than the default one, see `occlusion_gen.c`
+#if FOV_SIZE != 5U
+#include "occlusion_rules.h"
+#endif
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#ifdef ENGINE_THREADS
+#include <pthread.h>
+#endif
+
 #ifndef unreachable
 #ifdef __GNUC__
 #define unreachable() (__builtin_unreachable())
@@ -11,69 +26,99 @@
 #endif
 #endif
 
-#define AGENT_STATE_VERSION 0x00010001U
-#define AGENT_STATE_SIZE 11U
-#define RNG_SEED 0x12345678U
-#define FOV_SIZE 5U
-#define FOV_SELF_IDX 22U
+#define SCRATCH_MAX_FEATURES 8U
+#define SCRATCH_HEADER_SIZE (2U + SCRATCH_MAX_FEATURES)
+#define BITBOARD_HALO (FOV_SIZE - 1U)
+#define BITS_PER_WORD 64U
+#define FOV_MASK_WORDS                                                         \
+    (((FOV_SIZE * FOV_SIZE) + BITS_PER_WORD - 1U) / BITS_PER_WORD)
+#define MAX_THREADS 256U
+#define MIN_AGENTS_PER_THREAD 256U
+#define NO_CLAIM UINT32_MAX
+#define CHUNK_TILES 64U
+#define FORK_HEADER_SIZE 5U
+#define UNDO_LOG_HEADER_SIZE 4U
+#define UNDO_KIND_SHIFT 62U
+#define UNDO_INDEX_MASK ((1U << 30U) - 1U)
+#define FRAME_STACK_HEADER_SIZE 6U
+#define DUNGEON_MIN_LEAF 6U
+#define DUNGEON_MIN_SIZE 4U
+#define DUNGEON_STACK_SIZE 64U
+#define PATH_CACHE_HEADER_SIZE 3U
+#define PATH_DOOR_COST 2U
+#define NO_GOAL UINT32_MAX
+#define EXPLORATION_HEADER_SIZE 4U
+#define CHUNK_SIDE 8U
+#define SLOT_WORDS 10U
+#define DIRTY_OVERFLOW UINT64_MAX
+#define NO_AGENT UINT32_MAX
+#define PACKED_TILES_PER_WORD 10U
+#define PACKED_STATE_SIZE                                                      \
+    (((FOV_SIZE * FOV_SIZE) + PACKED_TILES_PER_WORD - 1U)                      \
+     / PACKED_TILES_PER_WORD)
+#define SHADOWCAST_STACK_SIZE                                                  \
+    ((SHADOWCAST_MAX_RADIUS * (SHADOWCAST_MAX_RADIUS + 3U)) / 2U)
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-enum Action : uint32_t
-{
-    ACTION_NONE = 0,
-    ACTION_TURN_90 = 1,
-    ACTION_TURN_180 = 2,
-    ACTION_TURN_270 = 3,
-    ACTION_MOVE_UP = 4,
-    ACTION_MOVE_RIGHT = 5,
-    ACTION_MOVE_DOWN = 6,
-    ACTION_MOVE_LEFT = 7,
-    ACTION_OPEN_DOOR = 8,
-    ACTION_CLOSE_DOOR = 9,
-};
-
-enum Tile : uint8_t
+struct Agents
 {
-    TILE_HIDDEN = 0x00,
-    TILE_WALL = 0x11,
-    TILE_FLOOR = 0x02,
-    TILE_FLOOR_OCCUPIED = 0x12,
-    TILE_OPEN_DOOR = 0x03,
-    TILE_OPEN_DOOR_OCCUPIED = 0x13,
-    TILE_CLOSED_DOOR = 0x33,
+    uint32_t n_agents;
+    uint32_t *positions;
+    enum Orientation *orientations;
 };
 
-enum Orientation : uint32_t
+/* Tiles of a forked map in chunks of `CHUNK_TILES`, where chunks are shared
+ * with the parent until they are written to for the first time.
+ */
+struct ChunkTable
 {
-    ORIENTATION_UP,
-    ORIENTATION_RIGHT,
-    ORIENTATION_DOWN,
-    ORIENTATION_LEFT,
+    enum Tile **chunks; // chunk `i` starts at tile `i * CHUNK_TILES`
+    enum Tile *pool;    // chunks owned by the fork
+    uint64_t *n_owned;
+    size_t n_tiles;
 };
 
-struct Agents
+/* Tiles changed during a tick, which are both listed and set in a bitboard
+ * of the same layout as the one of blocked tiles.
+ */
+struct DirtyTiles
 {
-    uint32_t n_agents;
-    uint32_t *positions;
-    enum Orientation *orientations;
+    uint64_t *bits;
+    uint64_t *n_tiles; // number of listed tiles or `DIRTY_OVERFLOW`
+    uint32_t *tiles;
+    uint32_t capacity;
 };
 
 struct Map
 {
     uint32_t n_rows;
     uint32_t n_cols;
+    uint32_t stride;  // tiles per row including the halo
+    uint32_t padding; // width of the halo
     enum Tile *tiles;
+    uint64_t *blocked; // optional bitboard of blocked tiles
+    uint32_t blocked_stride;
+    const struct ChunkTable *chunks; // replaces `tiles` of forked maps
+    uint64_t *undo_log; // optional journal of changes, see `record_change()`
+    const struct DirtyTiles *dirty; // optional set of changed tiles
 };
 
 struct World
 {
-    uint32_t rng_state;
+    uint64_t rng_key;
     struct Agents agents;
     struct Map map;
+    uint32_t *claims;  // optional claim table with one rank per tile
+    uint32_t *targets; // tile claimed by each agent if `claims` is set
+    struct DirtyTiles dirty; // referenced by `map.dirty` if set
+    uint64_t *poses; // pose of each agent at its last observation
+    uint32_t *agent_ids; // optional agent on each tile or `NO_AGENT`
+    bool packs_states;   // whether agent states are written packed
+    const uint32_t *previous_states; // copied for agents skipped by the cache
 };
 
 struct Pose
@@ -82,6 +127,47 @@ struct Pose
     enum Orientation heading;
 };
 
+[[nodiscard]] static uint32_t count_trailing_zeros(const uint32_t mask)
+{
+#ifdef __GNUC__
+    return (uint32_t)__builtin_ctz(mask);
+#else
+    uint32_t n_zeros = 0U;
+    while (((mask >> n_zeros) & 1U) == 0)
+    {
+        n_zeros++;
+    }
+    return n_zeros;
+#endif
+}
+
+[[nodiscard]] static uint32_t count_trailing_zeros64(const uint64_t mask)
+{
+#ifdef __GNUC__
+    return (uint32_t)__builtin_ctzll(mask);
+#else
+    uint32_t n_zeros = 0U;
+    while (((mask >> n_zeros) & 1U) == 0)
+    {
+        n_zeros++;
+    }
+    return n_zeros;
+#endif
+}
+
+static void copy_bytes(void *dst, const void *src, const size_t n_bytes)
+{
+#ifdef __GNUC__
+    // lowers to `memory.copy` in wasm builds
+    __builtin_memcpy(dst, src, n_bytes);
+#else
+    for (size_t i = 0; i < n_bytes; i++)
+    {
+        ((uint8_t *)dst)[i] = ((const uint8_t *)src)[i];
+    }
+#endif
+}
+
 [[nodiscard]] static uint32_t is_tile_blocked(const enum Tile tile)
 {
     // NOLINTNEXTLINE(readability-magic-numbers)
@@ -100,8 +186,192 @@ struct Pose
     return tile & ~0x10;
 }
 
+[[nodiscard]] static uint32_t bitboard_stride(const uint32_t n_cols)
+{
+    // one spare word per row allows reading two words unconditionally
+    return ((n_cols + (2U * BITBOARD_HALO) + BITS_PER_WORD - 1U)
+            / BITS_PER_WORD)
+        + 1U;
+}
+
+[[nodiscard]] static size_t bitboard_words(const struct Map *map)
+{
+    return (size_t)(map->n_rows + (2U * BITBOARD_HALO))
+        * bitboard_stride(map->n_cols);
+}
+
+/* Returns the word of a bitboard of the map, e.g., `map->blocked`, that stores
+ * the tile at `row` and `col`, where both are given in padded coordinates,
+ * i.e., are shifted by `BITBOARD_HALO` w.r.t. the map.
+ */
+[[nodiscard]] static uint64_t *bitboard_word(const struct Map *map,
+                                             uint64_t *board,
+                                             const uint32_t row,
+                                             const uint32_t col)
+{
+    return board + ((size_t)row * map->blocked_stride) + (col / BITS_PER_WORD);
+}
+
+static void set_bitboard_bit(const struct Map *map,
+                             uint64_t *board,
+                             const uint32_t pos,
+                             const uint32_t value)
+{
+    const uint32_t row = (pos / map->stride) + BITBOARD_HALO - map->padding;
+    const uint32_t col = (pos % map->stride) + BITBOARD_HALO - map->padding;
+
+    uint64_t *word = bitboard_word(map, board, row, col);
+    const uint64_t bit = 1ULL << (col % BITS_PER_WORD);
+    *word = value ? (*word | bit) : (*word & ~bit);
+}
+
+/* Returns `FOV_SIZE` consecutive bits of a bitboard starting at `row` and
+ * `col` (in padded coordinates).
+ */
+[[nodiscard]] static uint32_t bitboard_row_bits(const struct Map *map,
+                                                uint64_t *board,
+                                                const uint32_t row,
+                                                const uint32_t col)
+{
+    const uint64_t *word = bitboard_word(map, board, row, col);
+    const uint32_t shift = col % BITS_PER_WORD;
+
+    const uint64_t bits = (word[0] >> shift)
+        | ((word[1] << 1U) << (BITS_PER_WORD - 1U - shift));
+    return (uint32_t)(bits & ((1U << FOV_SIZE) - 1U));
+}
+
+/* Kinds of entries of an undo log. Each entry holds its kind in the upper two
+ * bits, the index of the changed tile or agent in the next 30 bits and the
+ * previous value in the lower 32 bits.
+ */
+enum UndoEntry : uint32_t
+{
+    UNDO_TICK, // start of a tick
+    UNDO_TILE,
+    UNDO_POSITION,
+    UNDO_ORIENTATION,
+};
+
+/* Appends an entry to the undo log, see `init_undo_log()` for its layout.
+ */
+static void record_change(uint64_t *undo_log,
+                          const enum UndoEntry kind,
+                          const uint32_t idx,
+                          const uint32_t old_value)
+{
+    const uint64_t n_entries = undo_log[2];
+    undo_log[UNDO_LOG_HEADER_SIZE + (size_t)n_entries] =
+        ((uint64_t)kind << UNDO_KIND_SHIFT) | ((uint64_t)idx << 32U)
+        | old_value;
+    undo_log[2] = n_entries + 1U;
+}
+
+[[nodiscard]] static enum Tile tile_at(const struct Map *map,
+                                      const uint32_t pos)
+{
+    if (map->chunks != NULL)
+    {
+        return map->chunks->chunks[pos / CHUNK_TILES][pos % CHUNK_TILES];
+    }
+
+    return map->tiles[pos];
+}
+
+/* Copies chunk `idx` into the pool of the fork unless it is already owned,
+ * where `tick_fork()` ensures that the pool has room for all chunks a tick
+ * writes to.
+ */
+[[nodiscard]] static enum Tile *own_chunk(const struct ChunkTable *table,
+                                          const uint32_t idx)
+{
+    enum Tile *chunk = table->chunks[idx];
+    const uint64_t n_owned = *table->n_owned;
+
+    // chunks of the parent are never within the pool of the fork
+    const uintptr_t offset = (uintptr_t)chunk - (uintptr_t)table->pool;
+    if (offset < n_owned * CHUNK_TILES)
+    {
+        return chunk;
+    }
+
+    const size_t start = (size_t)idx * CHUNK_TILES;
+    const size_t n_tiles = (table->n_tiles - start < CHUNK_TILES)
+        ? table->n_tiles - start
+        : CHUNK_TILES;
+
+    enum Tile *copy = table->pool + (size_t)(n_owned * CHUNK_TILES);
+    copy_bytes(copy, chunk, n_tiles);
+    table->chunks[idx] = copy;
+    *table->n_owned = n_owned + 1U;
+
+    return copy;
+}
+
+/* Adds a tile to the set of changed tiles. A full list, e.g., after tiles
+ * have been changed by `untick()`, marks all tiles as changed.
+ */
+static void mark_dirty(const struct Map *map, const uint32_t pos)
+{
+    const struct DirtyTiles *dirty = map->dirty;
+    const uint64_t n_tiles = *dirty->n_tiles;
+    if (n_tiles >= dirty->capacity)
+    {
+        *dirty->n_tiles = DIRTY_OVERFLOW;
+        return;
+    }
+
+    set_bitboard_bit(map, dirty->bits, pos, 1U);
+    dirty->tiles[n_tiles] = pos;
+    *dirty->n_tiles = n_tiles + 1U;
+}
+
+static void
+set_tile(const struct Map *map, const uint32_t pos, const enum Tile tile)
+{
+    if (map->undo_log != NULL)
+    {
+        record_change(map->undo_log, UNDO_TILE, pos, tile_at(map, pos));
+    }
+
+    if (map->chunks != NULL)
+    {
+        own_chunk(map->chunks, pos / CHUNK_TILES)[pos % CHUNK_TILES] = tile;
+    }
+    else
+    {
+        map->tiles[pos] = tile;
+    }
+
+    if (map->blocked != NULL)
+    {
+        set_bitboard_bit(map, map->blocked, pos, is_tile_blocked(tile));
+    }
+
+    if (map->dirty != NULL)
+    {
+        mark_dirty(map, pos);
+    }
+}
+
+// returns the key of the random streams of a world, see `random_word()`
+[[nodiscard]] static uint64_t rng_key(const uint32_t seed,
+                                      const uint32_t world_id)
+{
+    // splitmix64 of the seed and world id, where keys have to be odd
+    uint64_t key = ((uint64_t)world_id << 32U) | seed;
+    key += 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27U)) * 0x94D049BB133111EBULL;
+    return (key ^ (key >> 31U)) | 1U;
+}
+
+// see `engine.h` for the supported layouts of world states
 static struct World load_world(uint32_t *world_state, const uint32_t seed)
 {
+    const uint32_t padding = (world_state[0] == WORLD_STATE_PADDED) ? 1U : 0U;
+    world_state += padding;
+
     const uint32_t n_agents = world_state[0];
 
     const struct Agents agents = {
@@ -109,20 +379,202 @@ static struct World load_world(uint32_t *world_state, const uint32_t seed)
         .positions = world_state + 1U,
         .orientations = (enum Orientation *)(world_state + 1U + n_agents)};
 
+    const uint32_t n_cols = world_state[2U + (2U * n_agents)];
     const struct Map map = {
         .n_rows = world_state[1U + (2U * n_agents)],
-        .n_cols = world_state[2U + (2U * n_agents)],
+        .n_cols = n_cols,
+        .stride = n_cols + (2U * MAP_HALO * padding),
+        .padding = MAP_HALO * padding,
         .tiles = (enum Tile *)(world_state + 3U + (size_t)(2U * n_agents))};
 
     const struct World world = {
-        .rng_state = seed ? seed : RNG_SEED, .agents = agents, .map = map};
+        .rng_key = rng_key(seed, 0U), .agents = agents, .map = map};
 
     return world;
 }
 
+[[nodiscard]] static size_t map_tiles(const struct Map *map)
+{
+    return (size_t)(map->n_rows + (2U * map->padding)) * map->stride;
+}
+
+// returns the size in words of the claim table and the claimed targets
+[[nodiscard]] static size_t claim_table_words(const struct World *world)
+{
+    const size_t n_claims = map_tiles(&world->map) + world->agents.n_agents;
+    return (n_claims + 1U) / 2U;
+}
+
+/* Returns the size in words of the observation cache, which holds the bitboard
+ * of changed tiles, their number, a list of up to two changed tiles per agent
+ * and the last observed pose of each agent.
+ */
+[[nodiscard]] static size_t observation_cache_words(const struct World *world)
+{
+    return bitboard_words(&world->map) + 1U
+        + (2U * (size_t)world->agents.n_agents);
+}
+
+/* Lays out the scratch buffer of `world` for the given set of features and
+ * returns its size in words. The header is only written if `scratch` is not
+ * NULL.
+ *
+ * Layout of the scratch buffer:
+ *  - word 0: `SCRATCH_VERSION`,
+ *  - word 1: enabled features (`enum ScratchFeature`),
+ *  - words 2 to `SCRATCH_HEADER_SIZE`: offset of each feature's region in
+ *    words (indexed by the bit position of the feature), zero if disabled,
+ *  - feature regions.
+ */
+static size_t layout_scratch(const struct World *world,
+                             const uint32_t features,
+                             uint64_t *scratch)
+{
+    size_t offset = SCRATCH_HEADER_SIZE;
+    uint64_t offsets[SCRATCH_MAX_FEATURES] = {};
+
+    if (features & SCRATCH_BITBOARD)
+    {
+        offsets[count_trailing_zeros(SCRATCH_BITBOARD)] = offset;
+        offset += bitboard_words(&world->map);
+    }
+
+    if (features & SCRATCH_CLAIM_TABLE)
+    {
+        offsets[count_trailing_zeros(SCRATCH_CLAIM_TABLE)] = offset;
+        offset += claim_table_words(world);
+    }
+
+    if (features & SCRATCH_OBSERVATION_CACHE)
+    {
+        offsets[count_trailing_zeros(SCRATCH_OBSERVATION_CACHE)] = offset;
+        offset += observation_cache_words(world);
+    }
+
+    if (features & SCRATCH_AGENT_GRID)
+    {
+        offsets[count_trailing_zeros(SCRATCH_AGENT_GRID)] = offset;
+        offset += (map_tiles(&world->map) + 1U) / 2U;
+    }
+
+    if (scratch != NULL)
+    {
+        scratch[0] = SCRATCH_VERSION;
+        scratch[1] = features;
+        for (uint32_t i = 0; i < SCRATCH_MAX_FEATURES; i++)
+        {
+            scratch[2U + i] = offsets[i];
+        }
+    }
+
+    return offset;
+}
+
+[[nodiscard]] static uint64_t *scratch_region(uint64_t *scratch,
+                                              const enum ScratchFeature feature)
+{
+    const uint64_t offset = scratch[2U + count_trailing_zeros(feature)];
+    return (offset != 0) ? scratch + offset : NULL;
+}
+
+static void attach_scratch(struct World *world, uint64_t *scratch)
+{
+    world->map.blocked = scratch_region(scratch, SCRATCH_BITBOARD);
+    world->map.blocked_stride = bitboard_stride(world->map.n_cols);
+
+    uint64_t *claims = scratch_region(scratch, SCRATCH_CLAIM_TABLE);
+    if (claims != NULL)
+    {
+        world->claims = (uint32_t *)claims;
+        world->targets = world->claims + map_tiles(&world->map);
+    }
+
+    uint64_t *cache = scratch_region(scratch, SCRATCH_OBSERVATION_CACHE);
+    if (cache != NULL)
+    {
+        const uint32_t n_agents = world->agents.n_agents;
+        const size_t n_words = bitboard_words(&world->map);
+        world->dirty = (struct DirtyTiles){
+            .bits = cache,
+            .n_tiles = cache + n_words,
+            .tiles = (uint32_t *)(cache + n_words + 1U),
+            .capacity = 2U * n_agents};
+        world->poses = cache + n_words + 1U + n_agents;
+        world->map.dirty = &world->dirty;
+    }
+
+    world->agent_ids = (uint32_t *)scratch_region(scratch, SCRATCH_AGENT_GRID);
+    world->packs_states = (scratch[1] & SCRATCH_PACKED_STATES) != 0;
+}
+
+static void init_bitboard(const struct Map *map)
+{
+    const size_t n_words = bitboard_words(map);
+    for (size_t i = 0; i < n_words; i++)
+    {
+        map->blocked[i] = 0U;
+    }
+
+    for (uint32_t row = 0; row < map->n_rows; row++)
+    {
+        const uint32_t row_start =
+            ((row + map->padding) * map->stride) + map->padding;
+        for (uint32_t pos = row_start; pos < row_start + map->n_cols; pos++)
+        {
+            if (is_tile_blocked(map->tiles[pos]))
+            {
+                set_bitboard_bit(map, map->blocked, pos, 1U);
+            }
+        }
+    }
+}
+
+// all observations are stale until the first tick with the cache
+static void init_observation_cache(const struct World *world)
+{
+    const size_t n_words = bitboard_words(&world->map);
+    for (size_t i = 0; i < n_words; i++)
+    {
+        world->dirty.bits[i] = 0U;
+    }
+
+    *world->dirty.n_tiles = DIRTY_OVERFLOW;
+}
+
+static void init_agent_grid(const struct World *world)
+{
+    const size_t n_tiles = map_tiles(&world->map);
+    for (size_t i = 0; i < n_tiles; i++)
+    {
+        world->agent_ids[i] = NO_AGENT;
+    }
+
+    for (uint32_t i = 0; i < world->agents.n_agents; i++)
+    {
+        world->agent_ids[world->agents.positions[i]] = i;
+    }
+}
+
+// the claim table is kept free of claims in between ticks
+static void init_claim_table(const struct World *world)
+{
+    const size_t n_tiles = map_tiles(&world->map);
+    for (size_t i = 0; i < n_tiles; i++)
+    {
+        world->claims[i] = NO_CLAIM;
+    }
+}
+
 [[nodiscard]] static uint32_t ahead(const struct Map map,
                                     const struct Pose pose)
 {
+    if (map.padding != 0)
+    {
+        // the halo keeps agents in bounds
+        const uint32_t steps[] = {-map.stride, 1U, map.stride, -1U};
+        return pose.position + steps[pose.heading];
+    }
+
     const uint32_t n_rows = map.n_rows;
     const uint32_t n_cols = map.n_cols;
 
@@ -169,17 +621,16 @@ try_move(const struct World *world, const enum Action action, uint32_t *pos)
     const uint32_t old_pos = *pos;
     *pos = ahead(world->map, pose);
 
-    enum Tile *tile = world->map.tiles + *pos;
-    if (is_tile_blocked(*tile))
+    const struct Map *map = &world->map;
+    const enum Tile tile = tile_at(map, *pos);
+    if (is_tile_blocked(tile))
     {
         *pos = old_pos;
     }
     else
     {
-        *tile = block_tile(*tile);
-
-        enum Tile *old_tile = world->map.tiles + old_pos;
-        *old_tile = unblock_tile(*old_tile);
+        set_tile(map, *pos, block_tile(tile));
+        set_tile(map, old_pos, unblock_tile(tile_at(map, old_pos)));
     }
 }
 
@@ -195,10 +646,10 @@ static void try_open_door(const struct Map map,
 {
     const struct Pose pose = {.position = pos, .heading = orientation};
 
-    enum Tile *tile = map.tiles + ahead(map, pose);
-    if (*tile == TILE_CLOSED_DOOR)
+    const uint32_t door = ahead(map, pose);
+    if (tile_at(&map, door) == TILE_CLOSED_DOOR)
     {
-        *tile = TILE_OPEN_DOOR;
+        set_tile(&map, door, TILE_OPEN_DOOR);
     }
 }
 
@@ -208,13 +659,26 @@ static void try_close_door(const struct Map map,
 {
     const struct Pose pose = {.position = pos, .heading = orientation};
 
-    enum Tile *tile = map.tiles + ahead(map, pose);
-    if (*tile == TILE_OPEN_DOOR)
+    const uint32_t door = ahead(map, pose);
+    if (tile_at(&map, door) == TILE_OPEN_DOOR)
     {
-        *tile = TILE_CLOSED_DOOR;
+        set_tile(&map, door, TILE_CLOSED_DOOR);
     }
 }
 
+// moves agent `idx` from `old_pos` to its current position in the agent grid
+static void move_in_agent_grid(const struct World *world,
+                               const uint32_t idx,
+                               const uint32_t old_pos)
+{
+    uint32_t *agent_ids = world->agent_ids;
+    if (agent_ids[old_pos] == idx)
+    {
+        agent_ids[old_pos] = NO_AGENT;
+    }
+    agent_ids[world->agents.positions[idx]] = idx;
+}
+
 static void try_realize_action(const struct World *world,
                                const enum Action action,
                                const uint32_t idx)
@@ -227,8 +691,15 @@ static void try_realize_action(const struct World *world,
     case ACTION_MOVE_RIGHT:
     case ACTION_MOVE_DOWN:
     case ACTION_MOVE_LEFT:
+    {
+        const uint32_t old_pos = world->agents.positions[idx];
         try_move(world, action, world->agents.positions + idx);
+        if (world->agent_ids != NULL)
+        {
+            move_in_agent_grid(world, idx, old_pos);
+        }
         break;
+    }
     case ACTION_TURN_90:
     case ACTION_TURN_180:
     case ACTION_TURN_270:
@@ -247,53 +718,102 @@ static void try_realize_action(const struct World *world,
     }
 }
 
-static void
-fill_agent_fov(const struct World *world, const uint32_t idx, enum Tile *tiles)
+/* The FoV window of an agent starts `row_offset` rows and `col_offset`
+ * columns from the agent (in map orientation). Row `i` and column `j` of the
+ * window map to tile `(row_step * i) + (col_step * j) + origin` of the FoV.
+ */
+struct FovFrame
 {
-    static_assert(FOV_SIZE % 2 == 1);
-
-    const uint32_t n_rows = world->map.n_rows;
-    const uint32_t n_cols = world->map.n_cols;
+    uint32_t row_step;
+    uint32_t col_step;
+    uint32_t origin;
+    uint32_t row_offset;
+    uint32_t col_offset;
+};
 
-    const uint32_t pos = world->agents.positions[idx];
+[[nodiscard]] static struct FovFrame fov_frame(const enum Orientation heading)
+{
+    static_assert(FOV_SIZE % 2 == 1);
 
-    uint32_t a; // NOLINT(readability-identifier-length)
-    uint32_t b; // NOLINT(readability-identifier-length)
-    uint32_t c; // NOLINT(readability-identifier-length)
-    uint32_t row_offset = pos / n_cols;
-    uint32_t col_offset = pos % n_cols;
-    switch (world->agents.orientations[idx])
+    switch (heading)
     {
     case ORIENTATION_UP:
-        a = FOV_SIZE;
-        b = 1U;
-        c = 0U;
-        row_offset -= FOV_SIZE - 1U;
-        col_offset -= (FOV_SIZE / 2U);
-        break;
+        return (struct FovFrame){.row_step = FOV_SIZE,
+                                 .col_step = 1U,
+                                 .origin = 0U,
+                                 .row_offset = -(FOV_SIZE - 1U),
+                                 .col_offset = -(FOV_SIZE / 2U)};
     case ORIENTATION_RIGHT:
-        a = 1U;
-        b = -FOV_SIZE;
-        c = FOV_SIZE * (FOV_SIZE - 1U);
-        row_offset -= (FOV_SIZE / 2U);
-        break;
+        return (struct FovFrame){.row_step = 1U,
+                                 .col_step = -FOV_SIZE,
+                                 .origin = FOV_SIZE * (FOV_SIZE - 1U),
+                                 .row_offset = -(FOV_SIZE / 2U),
+                                 .col_offset = 0U};
     case ORIENTATION_DOWN:
-        a = -FOV_SIZE;
-        b = -1U;
-        c = (FOV_SIZE * FOV_SIZE) - 1U;
-        col_offset -= (FOV_SIZE / 2U);
-        break;
+        return (struct FovFrame){.row_step = -FOV_SIZE,
+                                 .col_step = -1U,
+                                 .origin = (FOV_SIZE * FOV_SIZE) - 1U,
+                                 .row_offset = 0U,
+                                 .col_offset = -(FOV_SIZE / 2U)};
     case ORIENTATION_LEFT:
-        a = -1U;
-        b = FOV_SIZE;
-        c = FOV_SIZE - 1U;
-        row_offset -= (FOV_SIZE / 2U);
-        col_offset -= FOV_SIZE - 1U;
-        break;
+        return (struct FovFrame){.row_step = -1U,
+                                 .col_step = FOV_SIZE,
+                                 .origin = FOV_SIZE - 1U,
+                                 .row_offset = -(FOV_SIZE / 2U),
+                                 .col_offset = -(FOV_SIZE - 1U)};
     default:
         unreachable();
     }
 
+    return (struct FovFrame){};
+}
+
+[[nodiscard]] static enum Tile visible_tile(const enum Tile tile)
+{
+    return (tile == TILE_VOID) ? TILE_HIDDEN : tile;
+}
+
+/* Same as `fill_agent_fov()` for padded maps, where the window never leaves
+ * the map.
+ */
+static void fill_agent_fov_padded(const struct World *world,
+                                  const uint32_t idx,
+                                  enum Tile *tiles)
+{
+    const uint32_t stride = world->map.stride;
+    const struct FovFrame frame = fov_frame(world->agents.orientations[idx]);
+    const uint32_t window = world->agents.positions[idx]
+        + (frame.row_offset * stride) + frame.col_offset;
+
+    for (uint32_t i = 0; i < FOV_SIZE; i++)
+    {
+        for (uint32_t j = 0; j < FOV_SIZE; j++)
+        {
+            const uint32_t tile_idx =
+                (frame.row_step * i) + (frame.col_step * j) + frame.origin;
+            const uint32_t map_idx = window + (i * stride) + j;
+            tiles[tile_idx] = visible_tile(tile_at(&world->map, map_idx));
+        }
+    }
+}
+
+static void
+fill_agent_fov(const struct World *world, const uint32_t idx, enum Tile *tiles)
+{
+    if (world->map.padding != 0)
+    {
+        fill_agent_fov_padded(world, idx, tiles);
+        return;
+    }
+
+    const uint32_t n_rows = world->map.n_rows;
+    const uint32_t n_cols = world->map.n_cols;
+
+    const uint32_t pos = world->agents.positions[idx];
+    const struct FovFrame frame = fov_frame(world->agents.orientations[idx]);
+    const uint32_t row_offset = (pos / n_cols) + frame.row_offset;
+    const uint32_t col_offset = (pos % n_cols) + frame.col_offset;
+
     for (uint32_t i = 0; i < FOV_SIZE; i++)
     {
         for (uint32_t j = 0; j < FOV_SIZE; j++)
@@ -301,80 +821,448 @@ fill_agent_fov(const struct World *world, const uint32_t idx, enum Tile *tiles)
             const uint32_t row = row_offset + i;
             const uint32_t col = col_offset + j;
 
-            const uint32_t tile_idx = (a * i) + (b * j) + c;
+            const uint32_t tile_idx =
+                (frame.row_step * i) + (frame.col_step * j) + frame.origin;
             const uint32_t map_idx = (row * n_cols) + col;
             tiles[tile_idx] = (col < n_cols && row < n_rows)
-                ? world->map.tiles[map_idx]
+                ? tile_at(&world->map, map_idx)
                 : TILE_HIDDEN;
         }
     }
 }
 
-// NOLINTBEGIN(readability-function-cognitive-complexity)
-static void apply_occlusion(enum Tile *tiles)
-{
-    // NOLINTNEXTLINE(misc-redundant-expression,readability-magic-numbers)
-    static_assert(FOV_SIZE == 5U);
+/* The occlusion rules of the default FoV size are derived by hand, operate on
+ * masks of 25 bits, and are read from SIMD vectors directly.
+ */
+#if FOV_SIZE == 5U
 
-    enum : uint32_t
+[[nodiscard]] static uint32_t fov_blocked_mask(const enum Tile *tiles)
+{
+    uint32_t blocked = 0U;
+    for (uint32_t i = 0; i < FOV_SIZE * FOV_SIZE; i++)
     {
-        n_tiles = FOV_SIZE * FOV_SIZE
-    };
+        blocked |= is_tile_blocked(tiles[i]) << i;
+    }
 
-    uint32_t m[n_tiles]; // NOLINT(readability-identifier-length)
-    for (uint32_t i = 0; i < n_tiles; i++)
-    {
-        m[i] = is_tile_blocked(tiles[i]);
-    }
-
-    /* Indexing of FoV:
-     *
-     *  0  1  2  3  4
-     *  5  6  7  8  9
-     * 10 11 12 13 14
-     * 15 16 17 18 19
-     * 20 21 xx 23 24
-     *       ^^--- agent facing up
-     *
-     * Examples:
-     *  - agent cannot see tile 1 if 12 *or* 17 are blocked.
-     *  - agent cannot see tile 13 if 17 *and* 18 are blocked.
-     */
+    return blocked;
+}
+
+[[nodiscard]] static uint32_t spread_bit(const uint32_t mask,
+                                         const uint32_t idx)
+{
+    return 0U - ((mask >> idx) & 1U);
+}
+
+/* Returns the mask of hidden tiles given the mask of blocked tiles, where
+ * bit `i` refers to tile `i` of the FoV:
+ *
+ *  0  1  2  3  4
+ *  5  6  7  8  9
+ * 10 11 12 13 14
+ * 15 16 17 18 19
+ * 20 21 xx 23 24
+ *       ^^--- agent facing up
+ *
+ * Examples:
+ *  - agent cannot see tile 1 if 12 *or* 17 are blocked.
+ *  - agent cannot see tile 13 if 17 *and* 18 are blocked.
+ */
+// NOLINTBEGIN(readability-magic-numbers)
+[[nodiscard]] static uint32_t occlusion_mask(const uint32_t blocked)
+{
+    // NOLINTNEXTLINE(misc-redundant-expression)
+    static_assert(FOV_SIZE == 5U);
 
-    // NOLINTNEXTLINE(misc-redundant-expression, readability-magic-numbers)
+    // NOLINTNEXTLINE(misc-redundant-expression)
     static_assert(FOV_SELF_IDX == 22U);
 
-    // NOLINTBEGIN(readability-magic-numbers)
-    m[0] = m[11] || m[17] || (m[6] && (m[5] || m[16]));
-    m[1] = m[12] || m[17];
-    m[2] = m[7] || m[12] || m[17];
-    m[3] = m[12] || m[17];
-    m[4] = m[13] || m[17] || (m[8] && (m[9] || m[18]));
-    m[5] = m[11] || m[16] || m[17];
-    m[6] = m[17] || (m[12] && (m[11] || m[16]));
-    m[7] = m[12] || m[17];
-    m[8] = m[17] || (m[12] && (m[13] || m[18]));
-    m[9] = m[13] || m[17] || m[18];
-    m[10] = m[16] || ((m[11] || m[17]) && (m[15] || m[21]));
-    m[11] = m[16] && m[17];
-    m[12] = m[17];
-    m[14] = m[18] || ((m[13] || m[17]) && (m[19] || m[23]));
-    m[13] = m[17] && m[18];
-    m[15] = m[21];
-    m[16] = m[17] && m[21];
-    m[18] = m[17] && m[23];
-    m[19] = m[23];
-    m[20] = m[21];
-    m[22] = 0U;
-    m[24] = m[23];
-    // NOLINTEND(readability-magic-numbers)
+    // all bits set iff the respective tile is blocked
+    const uint32_t b05 = spread_bit(blocked, 5U);
+    const uint32_t b06 = spread_bit(blocked, 6U);
+    const uint32_t b07 = spread_bit(blocked, 7U);
+    const uint32_t b08 = spread_bit(blocked, 8U);
+    const uint32_t b09 = spread_bit(blocked, 9U);
+    const uint32_t b11 = spread_bit(blocked, 11U);
+    const uint32_t b12 = spread_bit(blocked, 12U);
+    const uint32_t b13 = spread_bit(blocked, 13U);
+    const uint32_t b15 = spread_bit(blocked, 15U);
+    const uint32_t b16 = spread_bit(blocked, 16U);
+    const uint32_t b17 = spread_bit(blocked, 17U);
+    const uint32_t b18 = spread_bit(blocked, 18U);
+    const uint32_t b19 = spread_bit(blocked, 19U);
+    const uint32_t b21 = spread_bit(blocked, 21U);
+    const uint32_t b23 = spread_bit(blocked, 23U);
 
-    for (uint32_t i = 0; i < n_tiles; i++)
-    {
-        tiles[i] = m[i] ? TILE_HIDDEN : tiles[i];
+    // tiles hidden by a single blocked tile
+    const uint32_t single = (b17 & (0x3FFU | (1U << 12) | (1U << 17)))
+        | (b12 & ((1U << 1) | (1U << 2) | (1U << 3) | (1U << 7)))
+        | (b11 & ((1U << 0) | (1U << 5)))
+        | (b13 & ((1U << 4) | (1U << 9)))
+        | (b16 & ((1U << 5) | (1U << 10)))
+        | (b18 & ((1U << 9) | (1U << 14)))
+        | (b07 & (1U << 2))
+        | (b21 & ((1U << 15) | (1U << 20) | (1U << 21)))
+        | (b23 & ((1U << 19) | (1U << 23) | (1U << 24)));
+
+    // tiles hidden by a combination of blocked tiles
+    const uint32_t combined = (b06 & (b05 | b16) & (1U << 0))
+        | (b08 & (b09 | b18) & (1U << 4))
+        | (b12 & (b11 | b16) & (1U << 6))
+        | (b12 & (b13 | b18) & (1U << 8))
+        | ((b11 | b17) & (b15 | b21) & (1U << 10))
+        | (b16 & b17 & (1U << 11))
+        | (b17 & b18 & (1U << 13))
+        | ((b13 | b17) & (b19 | b23) & (1U << 14))
+        | (b17 & b21 & (1U << 16))
+        | (b17 & b23 & (1U << 18));
+
+    return single | combined;
+}
+// NOLINTEND(readability-magic-numbers)
+
+static void hide_tiles(enum Tile *tiles, uint32_t hidden)
+{
+    while (hidden != 0)
+    {
+        tiles[count_trailing_zeros(hidden)] = TILE_HIDDEN;
+        hidden &= hidden - 1U;
+    }
+}
+
+static void apply_occlusion(enum Tile *tiles)
+{
+    hide_tiles(tiles, occlusion_mask(fov_blocked_mask(tiles)));
+}
+
+#ifndef __wasm_simd128__
+
+static void fov_hidden(const uint64_t *blocked, uint64_t *hidden)
+{
+    hidden[0] = occlusion_mask((uint32_t)blocked[0]);
+}
+
+#endif
+
+#else
+
+static_assert(OCCLUSION_FOV_SIZE == FOV_SIZE);
+static_assert(OCCLUSION_MASK_WORDS == FOV_MASK_WORDS);
+
+static void fov_hidden(const uint64_t *blocked, uint64_t *hidden)
+{
+    occlusion_hidden(blocked, hidden);
+}
+
+// hides the tiles of an FoV with the straight-line rules of `FOV_SIZE`
+static void apply_occlusion(enum Tile *tiles)
+{
+    uint64_t blocked[FOV_MASK_WORDS] = {};
+    for (uint32_t i = 0; i < FOV_SIZE * FOV_SIZE; i++)
+    {
+        blocked[i / BITS_PER_WORD] |= (uint64_t)is_tile_blocked(tiles[i])
+            << (i % BITS_PER_WORD);
+    }
+
+    uint64_t hidden[FOV_MASK_WORDS];
+    fov_hidden(blocked, hidden);
+
+    for (uint32_t i = 0; i < FOV_SIZE * FOV_SIZE; i++)
+    {
+        if (((hidden[i / BITS_PER_WORD] >> (i % BITS_PER_WORD)) & 1U) != 0U)
+        {
+            tiles[i] = TILE_HIDDEN;
+        }
+    }
+}
+
+#endif
+
+#if !defined(__wasm_simd128__) || FOV_SIZE != 5U
+
+/* Same as `fill_agent_fov()` followed by `apply_occlusion()`, but takes the
+ * blocked tiles from the bitboard of the map and reads only the tiles that
+ * stay visible.
+ */
+static void fill_occluded_fov(const struct World *world,
+                              const uint32_t idx,
+                              enum Tile *tiles)
+{
+    const struct Map *map = &world->map;
+    const uint32_t pos = world->agents.positions[idx];
+    const struct FovFrame frame = fov_frame(world->agents.orientations[idx]);
+    const uint32_t row_offset = (pos / map->stride) + frame.row_offset;
+    const uint32_t col_offset = (pos % map->stride) + frame.col_offset;
+
+    // the window in the coordinates of the bitboard
+    const uint32_t board_row = row_offset + BITBOARD_HALO - map->padding;
+    const uint32_t board_col = col_offset + BITBOARD_HALO - map->padding;
+
+    uint64_t blocked[FOV_MASK_WORDS] = {};
+    for (uint32_t i = 0; i < FOV_SIZE; i++)
+    {
+        uint32_t bits =
+            bitboard_row_bits(map, map->blocked, board_row + i, board_col);
+        while (bits != 0)
+        {
+            const uint32_t tile_idx = (frame.row_step * i)
+                + (frame.col_step * count_trailing_zeros(bits))
+                + frame.origin;
+            blocked[tile_idx / BITS_PER_WORD] |= 1ULL
+                << (tile_idx % BITS_PER_WORD);
+            bits &= bits - 1U;
+        }
+    }
+
+    uint64_t hidden[FOV_MASK_WORDS];
+    fov_hidden(blocked, hidden);
+
+    const uint32_t n_rows = map->n_rows + (2U * map->padding);
+    for (uint32_t i = 0; i < FOV_SIZE; i++)
+    {
+        for (uint32_t j = 0; j < FOV_SIZE; j++)
+        {
+            const uint32_t row = row_offset + i;
+            const uint32_t col = col_offset + j;
+            const uint32_t tile_idx =
+                (frame.row_step * i) + (frame.col_step * j) + frame.origin;
+            const uint64_t is_hidden =
+                (hidden[tile_idx / BITS_PER_WORD] >> (tile_idx % BITS_PER_WORD))
+                & 1U;
+
+            tiles[tile_idx] = (is_hidden == 0U && row < n_rows
+                               && col < map->stride)
+                ? visible_tile(tile_at(map, (row * map->stride) + col))
+                : TILE_HIDDEN;
+        }
+    }
+}
+
+#endif
+
+/* Returns whether the observation of agent `idx` has to be updated because
+ * its pose or a tile within its FoV window changed since its last observation.
+ */
+[[nodiscard]] static bool is_observation_stale(const struct World *world,
+                                               const uint32_t idx)
+{
+    const struct Map *map = &world->map;
+    const uint32_t pos = world->agents.positions[idx];
+    const enum Orientation heading = world->agents.orientations[idx];
+    const uint64_t pose = ((uint64_t)heading << 32U) | pos;
+
+    if (*map->dirty->n_tiles == DIRTY_OVERFLOW || world->poses[idx] != pose)
+    {
+        world->poses[idx] = pose;
+        return true;
+    }
+
+    const struct FovFrame frame = fov_frame(heading);
+    const uint32_t row = (pos / map->stride) + BITBOARD_HALO - map->padding
+        + frame.row_offset;
+    const uint32_t col = (pos % map->stride) + BITBOARD_HALO - map->padding
+        + frame.col_offset;
+
+    uint32_t bits = 0U;
+    for (uint32_t i = 0; i < FOV_SIZE; i++)
+    {
+        bits |= bitboard_row_bits(map, map->dirty->bits, row + i, col);
+    }
+
+    return bits != 0;
+}
+
+// clears the set of changed tiles after all observations are updated
+static void clear_dirty_tiles(const struct Map *map)
+{
+    const struct DirtyTiles *dirty = map->dirty;
+    if (*dirty->n_tiles == DIRTY_OVERFLOW)
+    {
+        const size_t n_words = bitboard_words(map);
+        for (size_t i = 0; i < n_words; i++)
+        {
+            dirty->bits[i] = 0U;
+        }
+    }
+    else
+    {
+        for (uint64_t i = 0; i < *dirty->n_tiles; i++)
+        {
+            set_bitboard_bit(map, dirty->bits, dirty->tiles[i], 0U);
+        }
+    }
+
+    *dirty->n_tiles = 0U;
+}
+
+#if defined(__wasm_simd128__) && FOV_SIZE == 5U
+
+/* Tiles 0-15 and 16-24 of an FoV, where the lanes beyond tile 24 are zero.
+ */
+struct FovVectors
+{
+    v128_t lo;
+    v128_t hi;
+};
+
+/* Same as `fill_agent_fov_padded()` but gathers the window rows into vectors.
+ * Each row is loaded into an 8-byte half of a vector, and the rows are moved
+ * to their position in the FoV by shuffling, where out-of-range indices select
+ * zero.
+ */
+[[nodiscard]] static struct FovVectors
+load_agent_fov_padded(const struct World *world, const uint32_t idx)
+{
+    // NOLINTNEXTLINE(misc-redundant-expression,readability-magic-numbers)
+    static_assert(FOV_SIZE == 5U);
+
+    // NOLINTBEGIN(readability-magic-numbers)
+
+    /* Shuffles of the vectors holding rows 0-1, 2-3, and 4 of the window to
+     * tiles 0-15 and, in the next three shuffles, to tiles 16-24 of the FoV
+     * for each heading, where index 16 selects zero.
+     */
+    // clang-format off
+    static const uint8_t shuffles[4U * 2U * 3U][16] = {
+        // ORIENTATION_UP
+        {0, 1, 2, 3, 4, 8, 9, 10, 11, 12, 16, 16, 16, 16, 16, 16},
+        {16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 0, 1, 2, 3, 4, 8},
+        {16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        {16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        {9, 10, 11, 12, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        {16, 16, 16, 16, 0, 1, 2, 3, 4, 16, 16, 16, 16, 16, 16, 16},
+        // ORIENTATION_RIGHT
+        {4, 12, 16, 16, 16, 3, 11, 16, 16, 16, 2, 10, 16, 16, 16, 1},
+        {16, 16, 4, 12, 16, 16, 16, 3, 11, 16, 16, 16, 2, 10, 16, 16},
+        {16, 16, 16, 16, 4, 16, 16, 16, 16, 3, 16, 16, 16, 16, 2, 16},
+        {9, 16, 16, 16, 0, 8, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        {16, 1, 9, 16, 16, 16, 0, 8, 16, 16, 16, 16, 16, 16, 16, 16},
+        {16, 16, 16, 1, 16, 16, 16, 16, 0, 16, 16, 16, 16, 16, 16, 16},
+        // ORIENTATION_DOWN
+        {16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 12},
+        {16, 16, 16, 16, 16, 12, 11, 10, 9, 8, 4, 3, 2, 1, 0, 16},
+        {4, 3, 2, 1, 0, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        {11, 10, 9, 8, 4, 3, 2, 1, 0, 16, 16, 16, 16, 16, 16, 16},
+        {16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        {16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        // ORIENTATION_LEFT
+        {16, 16, 16, 8, 0, 16, 16, 16, 9, 1, 16, 16, 16, 10, 2, 16},
+        {16, 8, 0, 16, 16, 16, 9, 1, 16, 16, 16, 10, 2, 16, 16, 16},
+        {0, 16, 16, 16, 16, 1, 16, 16, 16, 16, 2, 16, 16, 16, 16, 3},
+        {16, 16, 11, 3, 16, 16, 16, 12, 4, 16, 16, 16, 16, 16, 16, 16},
+        {11, 3, 16, 16, 16, 12, 4, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+        {16, 16, 16, 16, 4, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16},
+    };
+    // clang-format on
+
+    const uint32_t stride = world->map.stride;
+    const enum Orientation heading = world->agents.orientations[idx];
+    const struct FovFrame frame = fov_frame(heading);
+    const uint32_t window = world->agents.positions[idx]
+        + (frame.row_offset * stride) + frame.col_offset;
+    const enum Tile *row = world->map.tiles + window;
+
+    // rows are loaded as four plus one bytes to never read past the map
+    const v128_t zero = wasm_i64x2_const(0, 0);
+    v128_t rows01 = wasm_v128_load32_lane(row, zero, 0);
+    rows01 = wasm_v128_load8_lane(row + 4U, rows01, 4);
+    row += stride;
+    rows01 = wasm_v128_load32_lane(row, rows01, 2);
+    rows01 = wasm_v128_load8_lane(row + 4U, rows01, 12);
+    row += stride;
+    v128_t rows23 = wasm_v128_load32_lane(row, zero, 0);
+    rows23 = wasm_v128_load8_lane(row + 4U, rows23, 4);
+    row += stride;
+    rows23 = wasm_v128_load32_lane(row, rows23, 2);
+    rows23 = wasm_v128_load8_lane(row + 4U, rows23, 12);
+    row += stride;
+    v128_t row4 = wasm_v128_load32_lane(row, zero, 0);
+    row4 = wasm_v128_load8_lane(row + 4U, row4, 4);
+
+    // NOLINTEND(readability-magic-numbers)
+
+    const uint8_t(*shuffle)[16] = shuffles + ((size_t)heading * 6U);
+    struct FovVectors fov;
+    fov.lo = wasm_v128_or(
+        wasm_v128_or(wasm_i8x16_swizzle(rows01, wasm_v128_load(shuffle[0])),
+                     wasm_i8x16_swizzle(rows23, wasm_v128_load(shuffle[1]))),
+        wasm_i8x16_swizzle(row4, wasm_v128_load(shuffle[2])));
+    fov.hi = wasm_v128_or(
+        wasm_v128_or(wasm_i8x16_swizzle(rows01, wasm_v128_load(shuffle[3])),
+                     wasm_i8x16_swizzle(rows23, wasm_v128_load(shuffle[4]))),
+        wasm_i8x16_swizzle(row4, wasm_v128_load(shuffle[5])));
+
+    // same as `visible_tile()`
+    static_assert(TILE_HIDDEN == 0);
+    const v128_t void_tile = wasm_u8x16_splat(TILE_VOID);
+    fov.lo = wasm_v128_andnot(fov.lo, wasm_i8x16_eq(fov.lo, void_tile));
+    fov.hi = wasm_v128_andnot(fov.hi, wasm_i8x16_eq(fov.hi, void_tile));
+
+    return fov;
+}
+
+[[nodiscard]] static struct FovVectors
+load_agent_fov(const struct World *world, const uint32_t idx)
+{
+    if (world->map.padding != 0 && world->map.chunks == NULL)
+    {
+        return load_agent_fov_padded(world, idx);
     }
+
+    enum Tile tiles[2U * sizeof(v128_t)] = {};
+    fill_agent_fov(world, idx, tiles);
+
+    return (struct FovVectors){.lo = wasm_v128_load(tiles),
+                               .hi = wasm_v128_load(tiles + sizeof(v128_t))};
+}
+
+/* Same as `fov_blocked_mask()` of the tiles held by `fov`.
+ */
+[[nodiscard]] static uint32_t
+fov_vectors_blocked_mask(const struct FovVectors fov)
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    const v128_t flag = wasm_u8x16_splat(0x10);
+    const v128_t lo = wasm_i8x16_eq(wasm_v128_and(fov.lo, flag), flag);
+    const v128_t hi = wasm_i8x16_eq(wasm_v128_and(fov.hi, flag), flag);
+
+    return (uint32_t)wasm_i8x16_bitmask(lo)
+        | ((uint32_t)wasm_i8x16_bitmask(hi) << 16U);
+}
+
+/* Returns a vector whose lane `i` has all bits set iff bit `i` of `bits` is
+ * set.
+ */
+[[nodiscard]] static v128_t spread_bits(const uint32_t bits)
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    const v128_t halves = wasm_u16x8_splat((uint16_t)bits);
+    const v128_t bytes = wasm_i8x16_shuffle(
+        halves, halves, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+    const v128_t lanes = wasm_u8x16_const(
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128);
+    // NOLINTEND(readability-magic-numbers)
+
+    return wasm_i8x16_eq(wasm_v128_and(bytes, lanes), lanes);
 }
-// NOLINTEND(readability-function-cognitive-complexity)
+
+/* Same as `hide_tiles()` followed by storing the 25 tiles held by `fov`.
+ */
+static void store_agent_fov(const struct FovVectors fov,
+                            const uint32_t hidden,
+                            enum Tile *tiles)
+{
+    static_assert(TILE_HIDDEN == 0);
+    const v128_t lo = wasm_v128_andnot(fov.lo, spread_bits(hidden));
+    const v128_t hi = wasm_v128_andnot(fov.hi, spread_bits(hidden >> 16U));
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    wasm_v128_store(tiles, lo);
+    wasm_v128_store64_lane(tiles + 16U, hi, 0);
+    wasm_v128_store8_lane(tiles + 24U, hi, 8);
+    // NOLINTEND(readability-magic-numbers)
+}
+
+#endif
 
 static void update_agent_state(const struct World *world,
                                uint32_t *agent_state,
@@ -386,20 +1274,90 @@ static void update_agent_state(const struct World *world,
     agent_state[3] = FOV_SELF_IDX;
 
     enum Tile *tiles = (enum Tile *)(agent_state + 4U);
-    fill_agent_fov(world, idx, tiles);
-    apply_occlusion(tiles);
+
+#if defined(__wasm_simd128__) && FOV_SIZE == 5U
+    // the vectors already hold the blocked tiles, the bitboard is not read
+    const struct FovVectors fov = load_agent_fov(world, idx);
+    store_agent_fov(fov, occlusion_mask(fov_vectors_blocked_mask(fov)), tiles);
+#else
+    if (world->map.blocked != NULL)
+    {
+        fill_occluded_fov(world, idx, tiles);
+    }
+    else
+    {
+        fill_agent_fov(world, idx, tiles);
+        apply_occlusion(tiles);
+    }
+#endif
+}
+
+/* Returns the `enum PackedTile` code of a tile, i.e., its lower two bits and
+ * its blocked bit, where the bit of closed doors sets them apart from occupied
+ * open doors.
+ */
+[[nodiscard]] static uint32_t pack_tile(const enum Tile tile)
+{
+    // NOLINTBEGIN(readability-magic-numbers)
+    const uint32_t bits = (uint32_t)tile;
+    return ((bits & 0x3U) | ((bits >> 2U) & 0x4U)) ^ (((bits >> 5U) & 1U) * 6U);
+    // NOLINTEND(readability-magic-numbers)
 }
 
-[[nodiscard]] static uint32_t rng(uint32_t *rng_state)
+static void pack_agent_state(const uint32_t *agent_state, uint32_t *packed)
 {
-    enum : uint32_t
+    const enum Tile *tiles = (const enum Tile *)(agent_state + 4U);
+    for (uint32_t i = 0; i < PACKED_STATE_SIZE; i++)
     {
-        RNG_LCG_MUL = 1664525U,
-        RNG_LCG_INC = 1013904223U
-    };
+        uint32_t word = 0U;
+        for (uint32_t j = 0; j < PACKED_TILES_PER_WORD; j++)
+        {
+            const uint32_t tile_idx = (i * PACKED_TILES_PER_WORD) + j;
+            if (tile_idx < FOV_SIZE * FOV_SIZE)
+            {
+                word |= pack_tile(tiles[tile_idx]) << (3U * j);
+            }
+        }
+        packed[i] = word;
+    }
+}
+
+/* Independent random streams of a world, where each stream holds 2^32 words
+ * indexed by, e.g., the agent.
+ */
+enum RandomStream : uint32_t
+{
+    STREAM_ACTION_ORDER,
+    STREAM_DUNGEON,
+};
+
+/* Returns word `idx` of `stream` of the world, where words are drawn from the
+ * counter-based Squares generator (Widynski, 2020) keyed by the seed and id of
+ * the world. Hence, words can be drawn in any order and on any thread.
+ */
+[[nodiscard]] static uint32_t random_word(const struct World *world,
+                                          const enum RandomStream stream,
+                                          const uint32_t idx)
+{
+    const uint64_t key = world->rng_key;
+    const uint64_t counter = ((uint64_t)stream << 32U) | idx;
+
+    const uint64_t y = counter * key; // NOLINT(readability-identifier-length)
+    const uint64_t z = y + key;       // NOLINT(readability-identifier-length)
+    uint64_t x = (y * y) + y;         // NOLINT(readability-identifier-length)
+    x = (x >> 32U) | (x << 32U);
+    x = (x * x) + z;
+    x = (x >> 32U) | (x << 32U);
+    x = (x * x) + y;
+    x = (x >> 32U) | (x << 32U);
+    return (uint32_t)(((x * x) + z) >> 32U);
+}
 
-    *rng_state = (*rng_state * RNG_LCG_MUL) + RNG_LCG_INC;
-    return *rng_state;
+// maps a random word uniformly onto `[0, n)`
+[[nodiscard]] static uint32_t random_below(const uint32_t word,
+                                           const uint32_t n)
+{
+    return (uint32_t)(((uint64_t)word * n) >> 32U);
 }
 
 [[nodiscard]] uint32_t agent_state_size(void)
@@ -407,35 +1365,2549 @@ static void update_agent_state(const struct World *world,
     return AGENT_STATE_SIZE;
 }
 
-void tick(
-    uint32_t *world_state,  // NOLINT(bugprone-easily-swappable-parameters)
-    uint32_t *agent_states, // NOLINT(bugprone-easily-swappable-parameters)
-    const uint32_t *agent_actions,
-    const uint32_t seed)
+[[nodiscard]] uint32_t packed_state_size(void)
 {
-    struct World world = load_world(world_state, seed);
+    return PACKED_STATE_SIZE;
+}
 
-    const uint32_t n_agents = world.agents.n_agents;
-    if (n_agents == 0)
+void packed_state_header(uint32_t *header)
+{
+    header[0] = PACKED_STATE_VERSION;
+    header[1] = FOV_SIZE; // rows
+    header[2] = FOV_SIZE; // columns
+    header[3] = FOV_SELF_IDX;
+}
+
+// returns the size of a world state in bytes without trailing padding
+[[nodiscard]] static size_t world_state_bytes(uint32_t *world_state)
+{
+    const struct World world = load_world(world_state, 0U);
+    const struct Map *map = &world.map;
+
+    const size_t n_header_words = ((map->padding != 0) ? 4U : 3U)
+        + (2U * (size_t)world.agents.n_agents);
+
+    return (n_header_words * sizeof(uint32_t)) + map_tiles(map);
+}
+
+[[nodiscard]] static size_t world_state_words(uint32_t *world_state)
+{
+    return (world_state_bytes(world_state) + sizeof(uint32_t) - 1U)
+        / sizeof(uint32_t);
+}
+
+/* Runs `run(context, begin, end)` for consecutive ranges of `[0, n_items)`
+ * that together cover all items.
+ */
+struct Job
+{
+    void (*run)(void *context, uint32_t begin, uint32_t end);
+    void *context;
+    uint32_t n_items;
+};
+
+static void run_job_share(const struct Job *job,
+                          const uint32_t rank,
+                          const uint32_t n_ranks)
+{
+    const uint32_t begin =
+        (uint32_t)(((uint64_t)job->n_items * rank) / n_ranks);
+    const uint32_t end =
+        (uint32_t)(((uint64_t)job->n_items * (rank + 1U)) / n_ranks);
+    if (begin < end)
     {
-        return;
+        job->run(job->context, begin, end);
     }
+}
 
-    uint32_t idx = rng(&world.rng_state) % n_agents;
-    const uint32_t idx_increment =
-        (rng(&world.rng_state) % 2U == 0) ? 1U : (n_agents - 1U);
+#ifdef ENGINE_THREADS
 
-    for (uint32_t i = 0; i < n_agents; i++)
+struct Worker
+{
+    pthread_t thread;
+    uint32_t rank;
+    uint64_t generation; // generation of the pool when the worker was started
+};
+
+/* Workers wait for the generation of the pool to change and run their share
+ * of the current job, while the calling thread runs the share of rank 0.
+ * Jobs are posted and workers are (re-)started under `dispatch`, such that
+ * concurrent callers are serialized.
+ */
+struct ThreadPool
+{
+    pthread_mutex_t dispatch;
+    pthread_mutex_t mutex;
+    pthread_cond_t posted;
+    pthread_cond_t finished;
+    struct Job job;
+    uint64_t generation;
+    uint32_t n_pending;
+    uint32_t n_threads; // including the calling thread
+    bool shutdown;
+    struct Worker workers[MAX_THREADS];
+};
+
+static struct ThreadPool g_pool = {
+    .dispatch = PTHREAD_MUTEX_INITIALIZER,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .posted = PTHREAD_COND_INITIALIZER,
+    .finished = PTHREAD_COND_INITIALIZER,
+    .n_threads = 1U,
+};
+
+static void *run_worker(void *arg)
+{
+    const struct Worker *worker = (const struct Worker *)arg;
+    uint64_t generation = worker->generation;
+
+    pthread_mutex_lock(&g_pool.mutex);
+    while (true)
+    {
+        while (g_pool.generation == generation && !g_pool.shutdown)
+        {
+            pthread_cond_wait(&g_pool.posted, &g_pool.mutex);
+        }
+        if (g_pool.shutdown)
+        {
+            break;
+        }
+
+        generation = g_pool.generation;
+        const struct Job job = g_pool.job;
+        const uint32_t n_threads = g_pool.n_threads;
+        pthread_mutex_unlock(&g_pool.mutex);
+
+        run_job_share(&job, worker->rank, n_threads);
+
+        pthread_mutex_lock(&g_pool.mutex);
+        g_pool.n_pending--;
+        if (g_pool.n_pending == 0)
+        {
+            pthread_cond_signal(&g_pool.finished);
+        }
+    }
+    pthread_mutex_unlock(&g_pool.mutex);
+
+    return NULL;
+}
+
+// requires `g_pool.dispatch` to be held
+static void stop_workers(void)
+{
+    pthread_mutex_lock(&g_pool.mutex);
+    g_pool.shutdown = true;
+    pthread_cond_broadcast(&g_pool.posted);
+    pthread_mutex_unlock(&g_pool.mutex);
+
+    for (uint32_t i = 1; i < g_pool.n_threads; i++)
     {
-        idx = (idx + idx_increment) % n_agents;
-        try_realize_action(&world, agent_actions[idx], idx);
+        pthread_join(g_pool.workers[i].thread, NULL);
     }
 
-    for (uint32_t i = 0; i < n_agents; i++)
+    g_pool.shutdown = false;
+    g_pool.n_threads = 1U;
+}
+
+// requires `g_pool.dispatch` to be held and no workers to be running
+static void start_workers(const uint32_t n_threads)
+{
+    uint32_t rank = 1U;
+    for (; rank < n_threads; rank++)
+    {
+        struct Worker *worker = &g_pool.workers[rank];
+        worker->rank = rank;
+        worker->generation = g_pool.generation;
+        if (pthread_create(&worker->thread, NULL, run_worker, worker) != 0)
+        {
+            break;
+        }
+    }
+
+    g_pool.n_threads = rank;
+}
+
+static void parallel_for(const struct Job *job)
+{
+    pthread_mutex_lock(&g_pool.dispatch);
+    const uint32_t n_threads = g_pool.n_threads;
+
+    // small jobs are not worth waking up the workers
+    if (n_threads == 1U || job->n_items < MIN_AGENTS_PER_THREAD * n_threads)
+    {
+        pthread_mutex_unlock(&g_pool.dispatch);
+        run_job_share(job, 0U, 1U);
+        return;
+    }
+
+    pthread_mutex_lock(&g_pool.mutex);
+    g_pool.job = *job;
+    g_pool.n_pending = n_threads - 1U;
+    g_pool.generation++;
+    pthread_cond_broadcast(&g_pool.posted);
+    pthread_mutex_unlock(&g_pool.mutex);
+
+    run_job_share(job, 0U, n_threads);
+
+    pthread_mutex_lock(&g_pool.mutex);
+    while (g_pool.n_pending != 0)
     {
-        update_agent_state(
-            &world, agent_states + (size_t)(i * AGENT_STATE_SIZE), i);
+        pthread_cond_wait(&g_pool.finished, &g_pool.mutex);
     }
+    pthread_mutex_unlock(&g_pool.mutex);
+
+    pthread_mutex_unlock(&g_pool.dispatch);
+}
+
+#else
+
+static void parallel_for(const struct Job *job)
+{
+    run_job_share(job, 0U, 1U);
+}
+
+#endif
+
+struct ObservationJob
+{
+    const struct World *world;
+    uint32_t *agent_states;
+};
+
+static void update_agent_states(void *context,
+                                const uint32_t begin,
+                                const uint32_t end)
+{
+    const struct ObservationJob *job = (const struct ObservationJob *)context;
+    const bool is_cached = job->world->map.dirty != NULL;
+    const bool is_packed = job->world->packs_states;
+    const uint32_t size = is_packed ? PACKED_STATE_SIZE : AGENT_STATE_SIZE;
+    for (uint32_t i = begin; i < end; i++)
+    {
+        uint32_t *agent_state = job->agent_states + ((size_t)i * size);
+        if (is_cached && !is_observation_stale(job->world, i))
+        {
+            if (job->world->previous_states != NULL)
+            {
+                copy_bytes(agent_state,
+                           job->world->previous_states + ((size_t)i * size),
+                           size * sizeof(uint32_t));
+            }
+            continue;
+        }
+
+        if (is_packed)
+        {
+            uint32_t unpacked[AGENT_STATE_SIZE];
+            update_agent_state(job->world, unpacked, i);
+            pack_agent_state(unpacked, agent_state);
+        }
+        else
+        {
+            update_agent_state(job->world, agent_state, i);
+        }
+    }
+}
+
+/* Agents act in the order `(first + k * increment) % n_agents` for
+ * `k = 1, ..., n_agents`, where the increment steps either forwards or
+ * backwards.
+ */
+struct ActionOrder
+{
+    uint32_t first;
+    uint32_t increment;
+};
+
+[[nodiscard]] static struct ActionOrder
+action_order(const struct World *world)
+{
+    const uint32_t n_agents = world->agents.n_agents;
+    const uint32_t first =
+        random_below(random_word(world, STREAM_ACTION_ORDER, 0U), n_agents);
+    const uint32_t increment =
+        (random_word(world, STREAM_ACTION_ORDER, 1U) >> 31U == 0)
+        ? 1U
+        : (n_agents - 1U);
+
+    return (struct ActionOrder){.first = first, .increment = increment};
+}
+
+// returns `k - 1` of agent `idx` in the action order
+[[nodiscard]] static uint32_t action_rank(const struct ActionOrder order,
+                                          const uint32_t n_agents,
+                                          const uint32_t idx)
+{
+    return (order.increment == 1U)
+        ? (idx + n_agents - 1U - order.first) % n_agents
+        : (order.first + n_agents - 1U - idx) % n_agents;
+}
+
+/* Returns the tile that agent `idx` would change by its action at the start
+ * of the tick or `NO_CLAIM` if the action does not change any tile.
+ */
+[[nodiscard]] static uint32_t claimed_tile(const struct World *world,
+                                          const enum Action action,
+                                          const uint32_t idx)
+{
+    const struct Map map = world->map;
+    struct Pose pose = {.position = world->agents.positions[idx],
+                        .heading = world->agents.orientations[idx]};
+
+    switch (action)
+    {
+    case ACTION_NONE:
+    case ACTION_TURN_90:
+    case ACTION_TURN_180:
+    case ACTION_TURN_270:
+        break;
+    case ACTION_MOVE_UP:
+    case ACTION_MOVE_RIGHT:
+    case ACTION_MOVE_DOWN:
+    case ACTION_MOVE_LEFT:
+    {
+        // moving in place is prevented by the agent itself
+        pose.heading = (enum Orientation)(action - ACTION_MOVE_UP);
+        const uint32_t target = ahead(map, pose);
+        return is_tile_blocked(tile_at(&map, target)) ? NO_CLAIM : target;
+    }
+    case ACTION_OPEN_DOOR:
+    {
+        const uint32_t door = ahead(map, pose);
+        return (tile_at(&map, door) == TILE_CLOSED_DOOR) ? door : NO_CLAIM;
+    }
+    case ACTION_CLOSE_DOOR:
+    {
+        const uint32_t door = ahead(map, pose);
+        return (tile_at(&map, door) == TILE_OPEN_DOOR) ? door : NO_CLAIM;
+    }
+    }
+
+    return NO_CLAIM;
+}
+
+// lowers `*claim` to `rank` unless a lower rank has already been claimed
+static void claim_tile(uint32_t *claim, const uint32_t rank)
+{
+#ifdef __GNUC__
+    uint32_t current = __atomic_load_n(claim, __ATOMIC_RELAXED);
+    while (rank < current
+           && !__atomic_compare_exchange_n(
+               claim, &current, rank, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+#else
+    *claim = (rank < *claim) ? rank : *claim;
+#endif
+}
+
+struct ClaimJob
+{
+    const struct World *world;
+    const uint32_t *agent_actions;
+    struct ActionOrder order;
+};
+
+static void claim_tiles(void *context, const uint32_t begin, const uint32_t end)
+{
+    const struct ClaimJob *job = (const struct ClaimJob *)context;
+    const struct World *world = job->world;
+    const uint32_t n_agents = world->agents.n_agents;
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+        const enum Action action = job->agent_actions[i];
+        const uint32_t tile = claimed_tile(world, action, i);
+        world->targets[i] = tile;
+
+        if (tile != NO_CLAIM)
+        {
+            claim_tile(world->claims + tile,
+                       action_rank(job->order, n_agents, i));
+        }
+        else if (action >= ACTION_TURN_90 && action <= ACTION_TURN_270)
+        {
+            turn(action, world->agents.orientations + i);
+        }
+    }
+}
+
+/* Resolves all actions against the world at the start of the tick. Claims
+ * are made in parallel, while the successful claims, which change pairwise
+ * distinct tiles, are realized on the calling thread.
+ */
+static void resolve_claims(const struct World *world,
+                           const uint32_t *agent_actions,
+                           const struct ActionOrder order)
+{
+    const uint32_t n_agents = world->agents.n_agents;
+    struct ClaimJob claims = {
+        .world = world, .agent_actions = agent_actions, .order = order};
+    const struct Job job = {
+        .run = claim_tiles, .context = &claims, .n_items = n_agents};
+    parallel_for(&job);
+
+    const struct Map *map = &world->map;
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        const uint32_t tile = world->targets[i];
+        if (tile == NO_CLAIM
+            || world->claims[tile] != action_rank(order, n_agents, i))
+        {
+            continue;
+        }
+
+        // losing agents never match a released claim
+        world->claims[tile] = NO_CLAIM;
+
+        switch (agent_actions[i])
+        {
+        case ACTION_OPEN_DOOR:
+            set_tile(map, tile, TILE_OPEN_DOOR);
+            break;
+        case ACTION_CLOSE_DOOR:
+            set_tile(map, tile, TILE_CLOSED_DOOR);
+            break;
+        default:
+        {
+            uint32_t *pos = world->agents.positions + i;
+            const uint32_t old_pos = *pos;
+            set_tile(map, tile, block_tile(tile_at(map, tile)));
+            set_tile(map, old_pos, unblock_tile(tile_at(map, old_pos)));
+            *pos = tile;
+            if (world->agent_ids != NULL)
+            {
+                move_in_agent_grid(world, i, old_pos);
+            }
+            break;
+        }
+        }
+    }
+}
+
+/* Records the start of a tick and the pose of each agent that moves or turns.
+ * Changes of tiles are recorded by `set_tile()`.
+ */
+static void record_tick(const struct World *world,
+                        const uint32_t *agent_actions)
+{
+    uint64_t *undo_log = world->map.undo_log;
+    record_change(undo_log, UNDO_TICK, 0U, 0U);
+    undo_log[3]++;
+
+    for (uint32_t i = 0; i < world->agents.n_agents; i++)
+    {
+        const enum Action action = agent_actions[i];
+        if (action >= ACTION_MOVE_UP && action <= ACTION_MOVE_LEFT)
+        {
+            record_change(
+                undo_log, UNDO_POSITION, i, world->agents.positions[i]);
+        }
+        else if (action >= ACTION_TURN_90 && action <= ACTION_TURN_270)
+        {
+            record_change(
+                undo_log, UNDO_ORIENTATION, i, world->agents.orientations[i]);
+        }
+    }
+}
+
+static void observe_world(struct World *world, uint32_t *agent_states)
+{
+    // observations only read the map and are independent of each other
+    struct ObservationJob observations = {.world = world,
+                                          .agent_states = agent_states};
+    const struct Job job = {.run = update_agent_states,
+                            .context = &observations,
+                            .n_items = world->agents.n_agents};
+    parallel_for(&job);
+
+    if (world->map.dirty != NULL)
+    {
+        clear_dirty_tiles(&world->map);
+    }
+}
+
+static void tick_world(struct World *world,
+                       uint32_t *agent_states,
+                       const uint32_t *agent_actions)
+{
+    if (world->map.undo_log != NULL)
+    {
+        record_tick(world, agent_actions);
+    }
+
+    const uint32_t n_agents = world->agents.n_agents;
+    if (n_agents == 0)
+    {
+        return;
+    }
+
+    const struct ActionOrder order = action_order(world);
+    if (world->claims != NULL)
+    {
+        resolve_claims(world, agent_actions, order);
+    }
+    else
+    {
+        uint32_t idx = order.first;
+        for (uint32_t i = 0; i < n_agents; i++)
+        {
+            idx = (idx + order.increment) % n_agents;
+            try_realize_action(world, agent_actions[idx], idx);
+        }
+    }
+
+    observe_world(world, agent_states);
+}
+
+void tick(
+    uint32_t *world_state,  // NOLINT(bugprone-easily-swappable-parameters)
+    uint32_t *agent_states, // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t *agent_actions,
+    const uint32_t seed)
+{
+    struct World world = load_world(world_state, seed);
+    tick_world(&world, agent_states, agent_actions);
+}
+
+uint32_t set_thread_count(const uint32_t n_threads)
+{
+#ifdef ENGINE_THREADS
+    uint32_t n_requested = (n_threads == 0) ? 1U : n_threads;
+    if (n_requested > MAX_THREADS)
+    {
+        n_requested = MAX_THREADS;
+    }
+
+    pthread_mutex_lock(&g_pool.dispatch);
+    stop_workers();
+    start_workers(n_requested);
+    const uint32_t n_started = g_pool.n_threads;
+    pthread_mutex_unlock(&g_pool.dispatch);
+
+    return n_started;
+#else
+    (void)n_threads;
+    return 1U;
+#endif
+}
+
+[[nodiscard]] size_t padded_world_state_size(uint32_t *world_state)
+{
+    const struct World world = load_world(world_state, 0U);
+    const struct Map *map = &world.map;
+
+    const size_t n_tiles = (size_t)(map->n_rows + (2U * MAP_HALO))
+        * (map->n_cols + (2U * MAP_HALO));
+    const size_t n_tile_words =
+        (n_tiles + sizeof(uint32_t) - 1U) / sizeof(uint32_t);
+
+    return 4U + (2U * (size_t)world.agents.n_agents) + n_tile_words;
+}
+
+void pad_world_state(
+    uint32_t *world_state,  // NOLINT(bugprone-easily-swappable-parameters)
+    uint32_t *padded_state) // NOLINT(bugprone-easily-swappable-parameters)
+{
+    const struct World world = load_world(world_state, 0U);
+    const uint32_t n_agents = world.agents.n_agents;
+    const uint32_t n_rows = world.map.n_rows;
+    const uint32_t n_cols = world.map.n_cols;
+    const uint32_t stride = n_cols + (2U * MAP_HALO);
+
+    padded_state[0] = WORLD_STATE_PADDED;
+    padded_state[1] = n_agents;
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        const uint32_t pos = world.agents.positions[i];
+        const uint32_t row = (pos / n_cols) + MAP_HALO;
+        const uint32_t col = (pos % n_cols) + MAP_HALO;
+
+        padded_state[2U + i] = (row * stride) + col;
+        padded_state[2U + n_agents + i] = world.agents.orientations[i];
+    }
+    padded_state[2U + (2U * n_agents)] = n_rows;
+    padded_state[3U + (2U * n_agents)] = n_cols;
+
+    enum Tile *tiles =
+        (enum Tile *)(padded_state + 4U + (size_t)(2U * n_agents));
+    for (uint32_t row = 0; row < n_rows + (2U * MAP_HALO); row++)
+    {
+        for (uint32_t col = 0; col < stride; col++)
+        {
+            const uint32_t inner_row = row - MAP_HALO;
+            const uint32_t inner_col = col - MAP_HALO;
+
+            tiles[(row * stride) + col] =
+                (inner_row < n_rows && inner_col < n_cols)
+                ? world.map.tiles[(inner_row * n_cols) + inner_col]
+                : TILE_VOID;
+        }
+    }
+}
+
+[[nodiscard]] size_t scratch_size(uint32_t *world_state,
+                                  const uint32_t features)
+{
+    const struct World world = load_world(world_state, 0U);
+    return layout_scratch(&world, features, NULL);
+}
+
+void init_scratch(uint32_t *world_state,
+                  uint64_t *scratch,
+                  const uint32_t features)
+{
+    struct World world = load_world(world_state, 0U);
+    layout_scratch(&world, features, scratch);
+    attach_scratch(&world, scratch);
+
+    if (world.map.blocked != NULL)
+    {
+        init_bitboard(&world.map);
+    }
+
+    if (world.claims != NULL)
+    {
+        init_claim_table(&world);
+    }
+
+    if (world.map.dirty != NULL)
+    {
+        init_observation_cache(&world);
+    }
+
+    if (world.agent_ids != NULL)
+    {
+        init_agent_grid(&world);
+    }
+}
+
+void tick_with_scratch(
+    uint32_t *world_state,  // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *scratch,
+    uint32_t *agent_states, // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t *agent_actions,
+    const uint32_t seed)
+{
+    struct World world = load_world(world_state, seed);
+    attach_scratch(&world, scratch);
+    tick_world(&world, agent_states, agent_actions);
+}
+
+void tick_batch(
+    uint32_t *worlds,       // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t n_worlds,
+    uint32_t *agent_states, // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t *agent_actions,
+    const uint32_t *seeds)
+{
+    tick_batch_with_reset(
+        worlds, n_worlds, agent_states, agent_actions, seeds, NULL, NULL);
+}
+
+[[nodiscard]] size_t snapshot_size(uint32_t *world_state)
+{
+    return 2U + world_state_words(world_state);
+}
+
+void snapshot_world(
+    uint32_t *world_state, // NOLINT(bugprone-easily-swappable-parameters)
+    uint32_t *snapshot)    // NOLINT(bugprone-easily-swappable-parameters)
+{
+    const size_t n_bytes = world_state_bytes(world_state);
+
+    snapshot[0] = SNAPSHOT_VERSION;
+    snapshot[1] = (uint32_t)n_bytes;
+    copy_bytes(snapshot + 2U, world_state, n_bytes);
+}
+
+bool restore_world(uint32_t *world_state,
+                   uint64_t *scratch,
+                   const uint32_t *snapshot)
+{
+    // snapshots of larger worlds would overrun the world state
+    if (snapshot[0] != SNAPSHOT_VERSION
+        || snapshot[1] != world_state_bytes(world_state))
+    {
+        return false;
+    }
+
+    copy_bytes(world_state, snapshot + 2U, snapshot[1]);
+
+    if (scratch != NULL)
+    {
+        init_scratch(world_state, scratch, (uint32_t)scratch[1]);
+    }
+    return true;
+}
+
+/* Lays out a fork of `world_state`, which is either a world state or the
+ * world state of a fork without its tiles, and returns its size in words. The
+ * header is only written if `fork` is not NULL.
+ *
+ * Layout of a fork:
+ *  - word 0: `FORK_VERSION`,
+ *  - word 1: number of chunks the fork can own,
+ *  - word 2: number of chunks the fork owns,
+ *  - word 3: offset of the chunk table in words,
+ *  - word 4: offset of the owned chunks in words,
+ *  - words from `FORK_HEADER_SIZE`: world state without the tiles,
+ *  - chunk table with the address of each chunk of the map,
+ *  - owned chunks.
+ */
+static size_t
+layout_fork(uint32_t *world_state, const uint32_t n_chunks, uint64_t *fork)
+{
+    const struct World world = load_world(world_state, 0U);
+    const size_t n_tiles = map_tiles(&world.map);
+    const size_t n_header_bytes = world_state_bytes(world_state) - n_tiles;
+
+    const size_t table = FORK_HEADER_SIZE
+        + ((n_header_bytes + sizeof(uint64_t) - 1U) / sizeof(uint64_t));
+    const size_t pool = table + ((n_tiles + CHUNK_TILES - 1U) / CHUNK_TILES);
+
+    if (fork != NULL)
+    {
+        fork[0] = FORK_VERSION;
+        fork[1] = n_chunks;
+        fork[2] = 0U;
+        fork[3] = table;
+        fork[4] = pool;
+        copy_bytes(fork + FORK_HEADER_SIZE, world_state, n_header_bytes);
+    }
+
+    return pool + ((size_t)n_chunks * (CHUNK_TILES / sizeof(uint64_t)));
+}
+
+[[nodiscard]] static uint32_t *fork_world_state(uint64_t *fork)
+{
+    return (uint32_t *)(fork + FORK_HEADER_SIZE);
+}
+
+[[nodiscard]] static enum Tile **fork_chunks(uint64_t *fork)
+{
+    return (enum Tile **)(fork + fork[3]);
+}
+
+static struct World
+load_fork(uint64_t *fork, struct ChunkTable *table, const uint32_t seed)
+{
+    struct World world = load_world(fork_world_state(fork), seed);
+
+    table->chunks = fork_chunks(fork);
+    table->pool = (enum Tile *)(fork + fork[4]);
+    table->n_owned = fork + 2U;
+    table->n_tiles = map_tiles(&world.map);
+
+    world.map.tiles = NULL;
+    world.map.chunks = table;
+    return world;
+}
+
+[[nodiscard]] size_t fork_size(uint32_t *world_state, const uint32_t n_chunks)
+{
+    return layout_fork(world_state, n_chunks, NULL);
+}
+
+void fork_world(uint32_t *world_state,
+                uint64_t *fork,
+                const uint32_t n_chunks)
+{
+    layout_fork(world_state, n_chunks, fork);
+
+    const struct World world = load_world(world_state, 0U);
+    const size_t n_tiles = map_tiles(&world.map);
+    enum Tile **chunks = fork_chunks(fork);
+    for (size_t i = 0; i * CHUNK_TILES < n_tiles; i++)
+    {
+        chunks[i] = world.map.tiles + (i * CHUNK_TILES);
+    }
+}
+
+void fork_fork(uint64_t *parent, // NOLINT(bugprone-easily-swappable-parameters)
+               uint64_t *fork,   // NOLINT(bugprone-easily-swappable-parameters)
+               const uint32_t n_chunks)
+{
+    uint32_t *world_state = fork_world_state(parent);
+    layout_fork(world_state, n_chunks, fork);
+
+    const struct World world = load_world(world_state, 0U);
+    const size_t n_tiles = map_tiles(&world.map);
+    enum Tile **parent_chunks = fork_chunks(parent);
+    enum Tile **chunks = fork_chunks(fork);
+    for (size_t i = 0; i * CHUNK_TILES < n_tiles; i++)
+    {
+        chunks[i] = parent_chunks[i];
+    }
+}
+
+uint32_t tick_fork(
+    uint64_t *fork,
+    uint32_t *agent_states, // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t *agent_actions,
+    const uint32_t seed)
+{
+    struct ChunkTable table;
+    struct World world = load_fork(fork, &table, seed);
+
+    // each agent writes to at most two tiles per tick, e.g., when moving
+    const uint64_t n_unowned =
+        ((table.n_tiles + CHUNK_TILES - 1U) / CHUNK_TILES) - fork[2];
+    const uint64_t n_writes = 2U * (uint64_t)world.agents.n_agents;
+    if (fork[1] - fork[2] < ((n_writes < n_unowned) ? n_writes : n_unowned))
+    {
+        return FORK_FULL;
+    }
+
+    tick_world(&world, agent_states, agent_actions);
+
+    return (uint32_t)(fork[1] - fork[2]);
+}
+
+// a tick changes at most one pose and two tiles per agent
+[[nodiscard]] static size_t undo_entries_per_tick(const uint32_t n_agents)
+{
+    return 1U + (3U * (size_t)n_agents);
+}
+
+[[nodiscard]] size_t undo_log_size(uint32_t *world_state,
+                                   const uint32_t n_ticks)
+{
+    const struct World world = load_world(world_state, 0U);
+    return UNDO_LOG_HEADER_SIZE
+        + ((size_t)n_ticks * undo_entries_per_tick(world.agents.n_agents));
+}
+
+/* Layout of an undo log:
+ *  - word 0: `UNDO_LOG_VERSION`,
+ *  - word 1: capacity in entries,
+ *  - word 2: number of entries,
+ *  - word 3: number of recorded ticks,
+ *  - entries (`enum UndoEntry`).
+ */
+void init_undo_log(uint32_t *world_state,
+                   uint64_t *undo_log,
+                   const uint32_t n_ticks)
+{
+    undo_log[0] = UNDO_LOG_VERSION;
+    undo_log[1] = undo_log_size(world_state, n_ticks) - UNDO_LOG_HEADER_SIZE;
+    undo_log[2] = 0U;
+    undo_log[3] = 0U;
+}
+
+uint32_t tick_with_undo_log(
+    uint32_t *world_state,  // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *scratch,      // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *undo_log,
+    uint32_t *agent_states, // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t *agent_actions,
+    const uint32_t seed)
+{
+    struct World world = load_world(world_state, seed);
+    if (scratch != NULL)
+    {
+        attach_scratch(&world, scratch);
+    }
+    world.map.undo_log = undo_log;
+    tick_world(&world, agent_states, agent_actions);
+
+    return (uint32_t)((undo_log[1] - undo_log[2])
+                      / undo_entries_per_tick(world.agents.n_agents));
+}
+
+uint32_t untick(
+    uint32_t *world_state,
+    uint64_t *scratch,  // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *undo_log) // NOLINT(bugprone-easily-swappable-parameters)
+{
+    struct World world = load_world(world_state, 0U);
+    if (scratch != NULL)
+    {
+        attach_scratch(&world, scratch);
+    }
+
+    uint64_t n_entries = undo_log[2];
+    while (n_entries != 0)
+    {
+        n_entries--;
+        const uint64_t entry =
+            undo_log[UNDO_LOG_HEADER_SIZE + (size_t)n_entries];
+        const uint32_t idx = (uint32_t)(entry >> 32U) & UNDO_INDEX_MASK;
+        const uint32_t old_value = (uint32_t)entry;
+
+        const enum UndoEntry kind = (enum UndoEntry)(entry >> UNDO_KIND_SHIFT);
+        if (kind == UNDO_TICK)
+        {
+            undo_log[3]--;
+            break;
+        }
+
+        switch (kind)
+        {
+        case UNDO_TILE:
+            set_tile(&world.map, idx, (enum Tile)old_value);
+            break;
+        case UNDO_POSITION:
+        {
+            const uint32_t pos = world.agents.positions[idx];
+            world.agents.positions[idx] = old_value;
+            if (world.agent_ids != NULL)
+            {
+                move_in_agent_grid(&world, idx, pos);
+            }
+            break;
+        }
+        case UNDO_ORIENTATION:
+            world.agents.orientations[idx] = (enum Orientation)old_value;
+            break;
+        default:
+            unreachable();
+        }
+    }
+    undo_log[2] = n_entries;
+
+    return (uint32_t)undo_log[3];
+}
+
+uint32_t visible_agents(
+    uint32_t *world_state, // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *scratch,
+    const uint32_t idx,
+    uint32_t *agent_ids) // NOLINT(bugprone-easily-swappable-parameters)
+{
+    struct World world = load_world(world_state, 0U);
+    attach_scratch(&world, scratch);
+    if (world.agent_ids == NULL)
+    {
+        return 0U;
+    }
+    const struct Map *map = &world.map;
+
+    enum Tile tiles[FOV_SIZE * FOV_SIZE];
+    fill_agent_fov(&world, idx, tiles);
+    apply_occlusion(tiles);
+
+    // agents by their tile in the FoV
+    uint32_t found[FOV_SIZE * FOV_SIZE];
+    for (uint32_t i = 0; i < FOV_SIZE * FOV_SIZE; i++)
+    {
+        found[i] = NO_AGENT;
+    }
+
+    const uint32_t pos = world.agents.positions[idx];
+    const struct FovFrame frame = fov_frame(world.agents.orientations[idx]);
+    const uint32_t row_offset = (pos / map->stride) + frame.row_offset;
+    const uint32_t col_offset = (pos % map->stride) + frame.col_offset;
+    const uint32_t n_rows = map->n_rows + (2U * map->padding);
+
+    for (uint32_t i = 0; i < FOV_SIZE; i++)
+    {
+        for (uint32_t j = 0; j < FOV_SIZE; j++)
+        {
+            const uint32_t row = row_offset + i;
+            const uint32_t col = col_offset + j;
+            const uint32_t tile_idx =
+                (frame.row_step * i) + (frame.col_step * j) + frame.origin;
+            if (row >= n_rows || col >= map->stride
+                || tiles[tile_idx] == TILE_HIDDEN)
+            {
+                continue;
+            }
+
+            const uint32_t agent = world.agent_ids[(row * map->stride) + col];
+            found[tile_idx] = (agent != idx) ? agent : NO_AGENT;
+        }
+    }
+
+    uint32_t n_found = 0U;
+    for (uint32_t i = 0; i < FOV_SIZE * FOV_SIZE; i++)
+    {
+        if (found[i] != NO_AGENT)
+        {
+            agent_ids[n_found++] = found[i];
+        }
+    }
+
+    return n_found;
+}
+
+/* The view of `observe_shadowcast()` of an agent at `row` and `col`, where
+ * stepping ahead or to the right of the agent moves by `ahead_*` or `right_*`
+ * rows and columns on the map.
+ */
+struct ShadowView
+{
+    const struct Map *map;
+    uint32_t row;
+    uint32_t col;
+    uint32_t ahead_row;
+    uint32_t ahead_col;
+    uint32_t right_row;
+    uint32_t right_col;
+    uint32_t radius;
+    enum Tile *tiles;
+};
+
+// quadrants of a view, each scanned row by row away from the agent
+enum ShadowQuadrant : uint32_t
+{
+    QUADRANT_AHEAD,
+    QUADRANT_RIGHT,
+    QUADRANT_LEFT,
+};
+
+/* The tiles at `depth` from the agent within a quadrant that lie between the
+ * slopes `start_num / start_den` and `end_num / end_den`.
+ */
+struct ShadowRow
+{
+    int32_t depth;
+    int32_t start_num;
+    int32_t start_den;
+    int32_t end_num;
+    int32_t end_den;
+};
+
+// rounds `num / den` towards negative infinity for `den > 0`
+[[nodiscard]] static int32_t floor_div(const int32_t num, const int32_t den)
+{
+    const int32_t quotient = num / den;
+    return (num % den != 0 && num < 0) ? quotient - 1 : quotient;
+}
+
+/* Returns the tile `ahead` tiles ahead of and `right` tiles to the right of
+ * the agent, where tiles beyond the map are `TILE_VOID`.
+ */
+[[nodiscard]] static enum Tile
+shadow_tile(const struct ShadowView *view,
+            const int32_t ahead,
+            const int32_t right)
+{
+    const struct Map *map = view->map;
+    const uint32_t row = view->row + ((uint32_t)ahead * view->ahead_row)
+        + ((uint32_t)right * view->right_row);
+    const uint32_t col = view->col + ((uint32_t)ahead * view->ahead_col)
+        + ((uint32_t)right * view->right_col);
+
+    return (row < map->n_rows + (2U * map->padding) && col < map->stride)
+        ? tile_at(map, (row * map->stride) + col)
+        : TILE_VOID;
+}
+
+/* Reveals the visible tiles of a quadrant by symmetric shadowcasting (Ford,
+ * 2021): each row spans the slopes that are not shadowed by blocked tiles
+ * closer to the agent, and a gap in a row continues as a narrower row. Rows
+ * are scanned from a stack instead of recursively, which holds at most
+ * `depth + 1` rows per depth, hence `1 <= radius <= SHADOWCAST_MAX_RADIUS`.
+ */
+static void scan_quadrant(const struct ShadowView *view,
+                          const enum ShadowQuadrant quadrant)
+{
+    const int32_t radius = (int32_t)view->radius;
+    const uint32_t n_cols = (2U * view->radius) + 1U;
+
+    struct ShadowRow rows[SHADOWCAST_STACK_SIZE];
+    uint32_t n_rows = 0U;
+    rows[n_rows++] = (struct ShadowRow){
+        .depth = 1,
+        .start_num = (quadrant == QUADRANT_AHEAD) ? -1 : 0,
+        .start_den = 1,
+        .end_num = 1,
+        .end_den = 1};
+
+    while (n_rows != 0)
+    {
+        struct ShadowRow row = rows[--n_rows];
+
+        // columns whose centers lie within the slopes, rounding ties outwards
+        const int32_t first_col = floor_div(
+            (2 * row.depth * row.start_num) + row.start_den, 2 * row.start_den);
+        const int32_t last_col = -floor_div(
+            row.end_den - (2 * row.depth * row.end_num), 2 * row.end_den);
+
+        bool was_blocked = false;
+        for (int32_t col = first_col; col <= last_col; col++)
+        {
+            int32_t ahead = row.depth;
+            int32_t right = col;
+            if (quadrant != QUADRANT_AHEAD)
+            {
+                ahead = col;
+                right = (quadrant == QUADRANT_RIGHT) ? row.depth : -row.depth;
+            }
+
+            const enum Tile tile = shadow_tile(view, ahead, right);
+            const bool is_blocked = is_tile_blocked(tile) != 0;
+
+            // unblocked tiles are revealed only if the agent is visible from
+            // them as well
+            if (is_blocked
+                || ((col * row.start_den >= row.depth * row.start_num)
+                    && (col * row.end_den <= row.depth * row.end_num)))
+            {
+                const uint32_t tile_idx = ((uint32_t)(radius - ahead) * n_cols)
+                    + (uint32_t)(radius + right);
+                view->tiles[tile_idx] = visible_tile(tile);
+            }
+
+            if (col != first_col && was_blocked && !is_blocked)
+            {
+                row.start_num = (2 * col) - 1;
+                row.start_den = 2 * row.depth;
+            }
+
+            if (col != first_col && !was_blocked && is_blocked
+                && row.depth < radius)
+            {
+                rows[n_rows++] = (struct ShadowRow){.depth = row.depth + 1,
+                                                    .start_num = row.start_num,
+                                                    .start_den = row.start_den,
+                                                    .end_num = (2 * col) - 1,
+                                                    .end_den = 2 * row.depth};
+            }
+            was_blocked = is_blocked;
+        }
+
+        if (first_col <= last_col && !was_blocked && row.depth < radius)
+        {
+            row.depth++;
+            rows[n_rows++] = row;
+        }
+    }
+}
+
+static void update_shadowcast_state(const struct World *world,
+                                    const uint32_t radius,
+                                    uint32_t *agent_state,
+                                    const uint32_t idx)
+{
+    const uint32_t n_cols = (2U * radius) + 1U;
+    agent_state[0] = AGENT_STATE_VERSION;
+    agent_state[1] = radius + 1U; // rows
+    agent_state[2] = n_cols;      // columns
+    agent_state[3] = (radius * n_cols) + radius;
+
+    // tiles that are not revealed stay hidden
+    static_assert(TILE_HIDDEN == 0);
+    const uint32_t size = shadowcast_state_size(radius);
+    for (uint32_t i = 4U; i < size; i++)
+    {
+        agent_state[i] = 0U;
+    }
+
+    const struct Map *map = &world->map;
+    const uint32_t pos = world->agents.positions[idx];
+    struct ShadowView view = {.map = map,
+                              .row = pos / map->stride,
+                              .col = pos % map->stride,
+                              .radius = radius,
+                              .tiles = (enum Tile *)(agent_state + 4U)};
+    switch (world->agents.orientations[idx])
+    {
+    case ORIENTATION_UP:
+        view.ahead_row = -1U;
+        view.right_col = 1U;
+        break;
+    case ORIENTATION_RIGHT:
+        view.ahead_col = 1U;
+        view.right_row = 1U;
+        break;
+    case ORIENTATION_DOWN:
+        view.ahead_row = 1U;
+        view.right_col = -1U;
+        break;
+    case ORIENTATION_LEFT:
+        view.ahead_col = -1U;
+        view.right_row = -1U;
+        break;
+    default:
+        unreachable();
+    }
+
+    view.tiles[agent_state[3]] = visible_tile(tile_at(map, pos));
+    scan_quadrant(&view, QUADRANT_AHEAD);
+    scan_quadrant(&view, QUADRANT_RIGHT);
+    scan_quadrant(&view, QUADRANT_LEFT);
+}
+
+struct ShadowcastJob
+{
+    const struct World *world;
+    uint32_t radius;
+    uint32_t *agent_states;
+};
+
+static void update_shadowcast_states(void *context,
+                                     const uint32_t begin,
+                                     const uint32_t end)
+{
+    const struct ShadowcastJob *job = (const struct ShadowcastJob *)context;
+    const uint32_t size = shadowcast_state_size(job->radius);
+    for (uint32_t i = begin; i < end; i++)
+    {
+        update_shadowcast_state(job->world,
+                                job->radius,
+                                job->agent_states + ((size_t)i * size),
+                                i);
+    }
+}
+
+uint32_t shadowcast_state_size(const uint32_t radius)
+{
+    const uint32_t n_tiles = (radius + 1U) * ((2U * radius) + 1U);
+    return 4U + ((n_tiles + 3U) / 4U);
+}
+
+void observe_shadowcast(uint32_t *world_state,
+                        const uint32_t radius,
+                        uint32_t *agent_states)
+{
+    // the window would be empty or the rows would overflow `scan_quadrant()`
+    if (radius == 0 || radius > SHADOWCAST_MAX_RADIUS)
+    {
+        return;
+    }
+
+    const struct World world = load_world(world_state, 0U);
+
+    struct ShadowcastJob observations = {
+        .world = &world, .radius = radius, .agent_states = agent_states};
+    const struct Job job = {.run = update_shadowcast_states,
+                            .context = &observations,
+                            .n_items = world.agents.n_agents};
+    parallel_for(&job);
+}
+
+/* Tiles belong to channel `c` of observation planes iff
+ * `(tile & mask) == value` for the rule `c`.
+ */
+struct PlaneRule
+{
+    uint8_t mask;
+    uint8_t value;
+};
+
+// NOLINTBEGIN(readability-magic-numbers)
+static const struct PlaneRule PLANE_RULES[PLANE_CHANNELS] = {
+    [PLANE_HIDDEN] = {.mask = 0xFF, .value = TILE_HIDDEN},
+    [PLANE_WALL] = {.mask = 0xFF, .value = TILE_WALL},
+    [PLANE_FLOOR] = {.mask = 0x2F, .value = TILE_FLOOR},
+    [PLANE_OCCUPIED] = {.mask = 0x3E, .value = TILE_FLOOR_OCCUPIED},
+    [PLANE_OPEN_DOOR] = {.mask = 0x2F, .value = TILE_OPEN_DOOR},
+    [PLANE_CLOSED_DOOR] = {.mask = 0xFF, .value = TILE_CLOSED_DOOR},
+};
+// NOLINTEND(readability-magic-numbers)
+
+struct PlaneJob
+{
+    const uint32_t *agent_states;
+    uint32_t n_tiles;
+    float *planes_f32; // either planes of floats or of bytes is set
+    uint8_t *planes_u8;
+};
+
+#ifdef __wasm_simd128__
+
+// returns lanes with all bits set iff the tile belongs to the channel
+[[nodiscard]] static v128_t plane_lanes(const enum Tile *tiles,
+                                        const struct PlaneRule rule)
+{
+    const v128_t bytes = wasm_v128_load(tiles);
+    return wasm_i8x16_eq(wasm_v128_and(bytes, wasm_u8x16_splat(rule.mask)),
+                         wasm_u8x16_splat(rule.value));
+}
+
+#endif
+
+static void write_planes_f32(const enum Tile *tiles,
+                             const uint32_t n_tiles,
+                             float *planes)
+{
+    for (uint32_t c = 0; c < PLANE_CHANNELS; c++)
+    {
+        const struct PlaneRule rule = PLANE_RULES[c];
+        float *plane = planes + ((size_t)c * n_tiles);
+
+        uint32_t i = 0;
+#ifdef __wasm_simd128__
+        const uint32_t n_lanes = (uint32_t)sizeof(v128_t);
+        const v128_t one = wasm_f32x4_splat(1.0F);
+        for (; i + n_lanes <= n_tiles; i += n_lanes)
+        {
+            // widens the byte lanes to float lanes in four steps
+            // NOLINTBEGIN(readability-magic-numbers)
+            const v128_t lanes = plane_lanes(tiles + i, rule);
+            const v128_t lo = wasm_i16x8_extend_low_i8x16(lanes);
+            const v128_t hi = wasm_i16x8_extend_high_i8x16(lanes);
+            wasm_v128_store(
+                plane + i,
+                wasm_v128_and(wasm_i32x4_extend_low_i16x8(lo), one));
+            wasm_v128_store(
+                plane + i + 4U,
+                wasm_v128_and(wasm_i32x4_extend_high_i16x8(lo), one));
+            wasm_v128_store(
+                plane + i + 8U,
+                wasm_v128_and(wasm_i32x4_extend_low_i16x8(hi), one));
+            wasm_v128_store(
+                plane + i + 12U,
+                wasm_v128_and(wasm_i32x4_extend_high_i16x8(hi), one));
+            // NOLINTEND(readability-magic-numbers)
+        }
+#endif
+        for (; i < n_tiles; i++)
+        {
+            plane[i] = ((tiles[i] & rule.mask) == rule.value) ? 1.0F : 0.0F;
+        }
+    }
+}
+
+static void write_planes_u8(const enum Tile *tiles,
+                            const uint32_t n_tiles,
+                            uint8_t *planes)
+{
+    for (uint32_t c = 0; c < PLANE_CHANNELS; c++)
+    {
+        const struct PlaneRule rule = PLANE_RULES[c];
+        uint8_t *plane = planes + ((size_t)c * n_tiles);
+
+        uint32_t i = 0;
+#ifdef __wasm_simd128__
+        const uint32_t n_lanes = (uint32_t)sizeof(v128_t);
+        const v128_t one = wasm_u8x16_splat(1);
+        for (; i + n_lanes <= n_tiles; i += n_lanes)
+        {
+            wasm_v128_store(plane + i,
+                            wasm_v128_and(plane_lanes(tiles + i, rule), one));
+        }
+#endif
+        for (; i < n_tiles; i++)
+        {
+            plane[i] = (uint8_t)((tiles[i] & rule.mask) == rule.value);
+        }
+    }
+}
+
+static void write_agent_planes(void *context,
+                               const uint32_t begin,
+                               const uint32_t end)
+{
+    const struct PlaneJob *job = (const struct PlaneJob *)context;
+    const uint32_t n_tiles = job->n_tiles;
+    const uint32_t size = 4U + ((n_tiles + 3U) / 4U);
+    const size_t n_entries = (size_t)PLANE_CHANNELS * n_tiles;
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+        const enum Tile *tiles =
+            (const enum Tile *)(job->agent_states + ((size_t)i * size) + 4U);
+        if (job->planes_f32 != NULL)
+        {
+            write_planes_f32(tiles, n_tiles, job->planes_f32 + (i * n_entries));
+        }
+        else
+        {
+            write_planes_u8(tiles, n_tiles, job->planes_u8 + (i * n_entries));
+        }
+    }
+}
+
+static void write_observation_planes(struct PlaneJob *planes,
+                                     const uint32_t n_agents)
+{
+    if (n_agents == 0)
+    {
+        return;
+    }
+
+    planes->n_tiles = planes->agent_states[1] * planes->agent_states[2];
+    const struct Job job = {
+        .run = write_agent_planes, .context = planes, .n_items = n_agents};
+    parallel_for(&job);
+}
+
+void observation_planes_f32(const uint32_t *agent_states,
+                            const uint32_t n_agents,
+                            float *planes)
+{
+    struct PlaneJob job = {.agent_states = agent_states, .planes_f32 = planes};
+    write_observation_planes(&job, n_agents);
+}
+
+void observation_planes_u8(const uint32_t *agent_states,
+                           const uint32_t n_agents,
+                           uint8_t *planes)
+{
+    struct PlaneJob job = {.agent_states = agent_states, .planes_u8 = planes};
+    write_observation_planes(&job, n_agents);
+}
+
+/* Layout of a frame stack:
+ *  - word 0: `FRAME_STACK_VERSION`,
+ *  - word 1: number of frames,
+ *  - word 2: size of an agent state in words,
+ *  - word 3: number of agents,
+ *  - word 4: index of the latest frame,
+ *  - word 5: number of written frames up to the number of frames,
+ * followed by the frames.
+ */
+[[nodiscard]] static size_t frame_words(const uint32_t *frames)
+{
+    return (size_t)frames[2] * frames[3];
+}
+
+[[nodiscard]] size_t frame_stack_size(uint32_t *world_state,
+                                      const uint32_t n_frames,
+                                      const uint32_t state_size)
+{
+    const struct World world = load_world(world_state, 0U);
+    return FRAME_STACK_HEADER_SIZE
+        + ((size_t)n_frames * state_size * world.agents.n_agents);
+}
+
+void init_frame_stack(uint32_t *world_state,
+                      uint32_t *frames,
+                      const uint32_t n_frames,
+                      const uint32_t state_size)
+{
+    const struct World world = load_world(world_state, 0U);
+    frames[0] = FRAME_STACK_VERSION;
+    frames[1] = n_frames;
+    frames[2] = state_size;
+    frames[3] = world.agents.n_agents;
+    frames[4] = n_frames - 1U; // the first tick writes frame 0
+    frames[5] = 0U;
+
+    const size_t n_words = (size_t)n_frames * frame_words(frames);
+    for (size_t i = 0; i < n_words; i++)
+    {
+        frames[FRAME_STACK_HEADER_SIZE + i] = 0U;
+    }
+}
+
+bool tick_with_frame_stack(
+    uint32_t *world_state, // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *scratch,
+    uint32_t *frames,
+    const uint32_t *agent_actions,
+    const uint32_t seed)
+{
+    struct World world = load_world(world_state, seed);
+    if (scratch != NULL)
+    {
+        attach_scratch(&world, scratch);
+    }
+
+    // frames of other agent states would be overrun by the tick
+    const uint32_t state_size =
+        world.packs_states ? PACKED_STATE_SIZE : AGENT_STATE_SIZE;
+    if (frames[1] == 0U || frames[2] != state_size
+        || frames[3] != world.agents.n_agents)
+    {
+        return false;
+    }
+
+    // agent states cannot be copied from a frame that was never written
+    if (world.map.dirty != NULL && frames[5] == 0U)
+    {
+        *world.dirty.n_tiles = DIRTY_OVERFLOW;
+    }
+
+    // a single frame already holds the states of skipped agents
+    world.previous_states =
+        (frames[1] > 1U) ? frame_stack_frame(frames, 0U) : NULL;
+    frames[4] = (frames[4] + 1U) % frames[1];
+    frames[5] += (frames[5] < frames[1]) ? 1U : 0U;
+    tick_world(&world, frame_stack_frame(frames, 0U), agent_actions);
+    return true;
+}
+
+[[nodiscard]] uint32_t *frame_stack_frame(uint32_t *frames, const uint32_t age)
+{
+    const uint32_t n_frames = frames[1];
+    const uint32_t slot = (frames[4] + n_frames - age) % n_frames;
+    return frames + FRAME_STACK_HEADER_SIZE + (slot * frame_words(frames));
+}
+
+void stack_frames(const uint32_t *frames, uint32_t *stacked)
+{
+    const uint32_t n_frames = frames[1];
+    const uint32_t state_size = frames[2];
+    const uint32_t n_agents = frames[3];
+    const size_t n_words = frame_words(frames);
+
+    for (uint32_t k = 0; k < n_frames; k++)
+    {
+        // the oldest frame follows the latest one
+        const uint32_t slot = (frames[4] + 1U + k) % n_frames;
+        const uint32_t *frame =
+            frames + FRAME_STACK_HEADER_SIZE + (slot * n_words);
+        for (uint32_t i = 0; i < n_agents; i++)
+        {
+            copy_bytes(stacked + ((((size_t)i * n_frames) + k) * state_size),
+                       frame + ((size_t)i * state_size),
+                       state_size * sizeof(uint32_t));
+        }
+    }
+}
+
+// a rectangle of a map in unpadded coordinates
+struct Area
+{
+    uint32_t row;
+    uint32_t col;
+    uint32_t n_rows;
+    uint32_t n_cols;
+};
+
+struct Dungeon
+{
+    const struct World *world;
+    uint32_t n_draws; // words drawn from `STREAM_DUNGEON`
+};
+
+[[nodiscard]] static uint32_t draw_below(struct Dungeon *dungeon,
+                                         const uint32_t n)
+{
+    const uint32_t word =
+        random_word(dungeon->world, STREAM_DUNGEON, dungeon->n_draws++);
+    return random_below(word, n);
+}
+
+[[nodiscard]] static uint32_t
+dungeon_pos(const struct Map *map, const uint32_t row, const uint32_t col)
+{
+    return ((row + map->padding) * map->stride) + col + map->padding;
+}
+
+/* Splits an area across its longer side into two parts of at least
+ * `DUNGEON_MIN_LEAF` rows or columns and returns whether it was large enough
+ * to be split.
+ */
+[[nodiscard]] static bool split_area(struct Dungeon *dungeon,
+                                     const struct Area area,
+                                     struct Area *parts)
+{
+    const bool is_tall = area.n_rows > area.n_cols;
+    const uint32_t size = is_tall ? area.n_rows : area.n_cols;
+    if (size < 2U * DUNGEON_MIN_LEAF)
+    {
+        return false;
+    }
+
+    const uint32_t cut = DUNGEON_MIN_LEAF
+        + draw_below(dungeon, size - (2U * DUNGEON_MIN_LEAF) + 1U);
+    parts[0] = area;
+    parts[1] = area;
+    if (is_tall)
+    {
+        parts[0].n_rows = cut;
+        parts[1].row += cut;
+        parts[1].n_rows -= cut;
+    }
+    else
+    {
+        parts[0].n_cols = cut;
+        parts[1].col += cut;
+        parts[1].n_cols -= cut;
+    }
+
+    return true;
+}
+
+/* Carves a room that spans at least half of the rows and columns of a leaf,
+ * whose last row and column remain walls between rooms, and returns the
+ * position of its center.
+ */
+[[nodiscard]] static uint32_t carve_room(struct Dungeon *dungeon,
+                                         const struct Area leaf)
+{
+    const struct Map *map = &dungeon->world->map;
+    const uint32_t max_rows = leaf.n_rows - 1U;
+    const uint32_t max_cols = leaf.n_cols - 1U;
+    const uint32_t n_rows =
+        ((max_rows + 1U) / 2U) + draw_below(dungeon, (max_rows / 2U) + 1U);
+    const uint32_t n_cols =
+        ((max_cols + 1U) / 2U) + draw_below(dungeon, (max_cols / 2U) + 1U);
+    const uint32_t row = leaf.row + draw_below(dungeon, max_rows - n_rows + 1U);
+    const uint32_t col = leaf.col + draw_below(dungeon, max_cols - n_cols + 1U);
+
+    for (uint32_t i = 0; i < n_rows; i++)
+    {
+        const uint32_t pos = dungeon_pos(map, row + i, col);
+        for (uint32_t j = 0; j < n_cols; j++)
+        {
+            map->tiles[pos + j] = TILE_FLOOR;
+        }
+    }
+
+    return dungeon_pos(map, row + (n_rows / 2U), col + (n_cols / 2U));
+}
+
+/* Carves a straight corridor from `from` to `to`, where `previous` is the tile
+ * at `from` before carving. Walls that lead from or into floor between two
+ * walls on the sides become closed doors.
+ */
+static void carve_corridor(const struct Map *map,
+                           const uint32_t from,
+                           const uint32_t to,
+                           const uint32_t step,
+                           const uint32_t side,
+                           enum Tile previous)
+{
+    for (uint32_t pos = from; pos != to;)
+    {
+        pos += step;
+        const enum Tile tile = map->tiles[pos];
+        if (tile == TILE_WALL)
+        {
+            const enum Tile next =
+                (pos != to) ? map->tiles[pos + step] : TILE_WALL;
+            const bool is_doorway =
+                (previous != TILE_WALL || next != TILE_WALL)
+                && map->tiles[pos - side] == TILE_WALL
+                && map->tiles[pos + side] == TILE_WALL;
+            map->tiles[pos] = is_doorway ? TILE_CLOSED_DOOR : TILE_FLOOR;
+        }
+        previous = tile;
+    }
+}
+
+// connects two rooms by a corridor that turns once at a random corner
+static void
+connect_rooms(struct Dungeon *dungeon, const uint32_t from, const uint32_t to)
+{
+    const struct Map *map = &dungeon->world->map;
+    const uint32_t stride = map->stride;
+    const uint32_t from_row = from / stride;
+    const uint32_t from_col = from % stride;
+    const uint32_t to_row = to / stride;
+    const uint32_t to_col = to % stride;
+
+    const uint32_t vertical = (to_row > from_row) ? stride : -stride;
+    const uint32_t horizontal = (to_col > from_col) ? 1U : -1U;
+
+    if (draw_below(dungeon, 2U) == 0)
+    {
+        const uint32_t corner = (to_row * stride) + from_col;
+        const enum Tile corner_tile = map->tiles[corner];
+        carve_corridor(map, from, corner, vertical, 1U, map->tiles[from]);
+        carve_corridor(map, corner, to, horizontal, stride, corner_tile);
+    }
+    else
+    {
+        const uint32_t corner = (from_row * stride) + to_col;
+        const enum Tile corner_tile = map->tiles[corner];
+        carve_corridor(map, from, corner, horizontal, stride, map->tiles[from]);
+        carve_corridor(map, corner, to, vertical, 1U, corner_tile);
+    }
+}
+
+/* Places the agents on distinct random floor tiles and returns the number of
+ * placed agents. Floor tiles are drawn in a single pass over the map by
+ * reservoir sampling, where the positions of the agents are the reservoir.
+ */
+[[nodiscard]] static uint32_t place_agents(struct Dungeon *dungeon)
+{
+    const struct World *world = dungeon->world;
+    const struct Map *map = &world->map;
+    const uint32_t n_agents = world->agents.n_agents;
+    uint32_t *positions = world->agents.positions;
+
+    uint32_t n_floor = 0U;
+    for (uint32_t row = 0; row < map->n_rows; row++)
+    {
+        const uint32_t row_start = dungeon_pos(map, row, 0U);
+        for (uint32_t pos = row_start; pos < row_start + map->n_cols; pos++)
+        {
+            if (map->tiles[pos] != TILE_FLOOR)
+            {
+                continue;
+            }
+
+            const uint32_t slot = (n_floor < n_agents)
+                ? n_floor
+                : draw_below(dungeon, n_floor + 1U);
+            if (slot < n_agents)
+            {
+                positions[slot] = pos;
+            }
+            n_floor++;
+        }
+    }
+
+    const uint32_t n_placed = (n_floor < n_agents) ? n_floor : n_agents;
+    for (uint32_t i = 0; i < n_placed; i++)
+    {
+        map->tiles[positions[i]] = TILE_FLOOR_OCCUPIED;
+        world->agents.orientations[i] =
+            (enum Orientation)draw_below(dungeon, 4U);
+    }
+
+    return n_placed;
+}
+
+[[nodiscard]] static uint32_t generate_world(const struct World *world)
+{
+    const struct Map *map = &world->map;
+    if (map->n_rows < DUNGEON_MIN_SIZE || map->n_cols < DUNGEON_MIN_SIZE)
+    {
+        return 0U;
+    }
+
+    struct Dungeon dungeon = {.world = world};
+
+    // walls within the halo of padded maps
+    const size_t n_tiles = map_tiles(map);
+    for (size_t i = 0; i < n_tiles; i++)
+    {
+        map->tiles[i] = (map->padding != 0) ? TILE_VOID : TILE_WALL;
+    }
+    for (uint32_t i = 0; map->padding != 0 && i < map->n_rows; i++)
+    {
+        const uint32_t pos = dungeon_pos(map, i, 0U);
+        for (uint32_t j = 0; j < map->n_cols; j++)
+        {
+            map->tiles[pos + j] = TILE_WALL;
+        }
+    }
+
+    /* Splits the map within its outer walls into leaves depth first, where
+     * the smaller part of a split is visited first such that each area on the
+     * stack is at least twice as large as the one above. Consecutive leaves
+     * are neighbors in the tree, and their rooms are connected.
+     */
+    struct Area areas[DUNGEON_STACK_SIZE];
+    uint32_t n_areas = 0U;
+    areas[n_areas++] = (struct Area){.row = 1U,
+                                     .col = 1U,
+                                     .n_rows = map->n_rows - 2U,
+                                     .n_cols = map->n_cols - 2U};
+
+    uint32_t previous_room = UINT32_MAX;
+    while (n_areas != 0)
+    {
+        const struct Area area = areas[--n_areas];
+        struct Area parts[2];
+        if (split_area(&dungeon, area, parts))
+        {
+            const uint32_t smaller =
+                (parts[0].n_rows * parts[0].n_cols
+                 <= parts[1].n_rows * parts[1].n_cols)
+                ? 0U
+                : 1U;
+            areas[n_areas++] = parts[1U - smaller];
+            areas[n_areas++] = parts[smaller];
+            continue;
+        }
+
+        const uint32_t room = carve_room(&dungeon, area);
+        if (previous_room != UINT32_MAX)
+        {
+            connect_rooms(&dungeon, previous_room, room);
+        }
+        previous_room = room;
+    }
+
+    return place_agents(&dungeon);
+}
+
+uint32_t generate_dungeon(uint32_t *world_state, const uint32_t seed)
+{
+    const struct World world = load_world(world_state, seed);
+    return generate_world(&world);
+}
+
+void tick_batch_with_reset(
+    uint32_t *worlds,       // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t n_worlds,
+    uint32_t *agent_states, // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t *agent_actions,
+    const uint32_t *seeds,
+    uint32_t *dones,
+    const uint32_t *snapshots)
+{
+    for (uint32_t i = 0; i < n_worlds; i++)
+    {
+        const bool is_done = dones != NULL && dones[i] != 0;
+        bool is_reset = false;
+        if (is_done && snapshots != NULL)
+        {
+            is_reset = restore_world(worlds, NULL, snapshots);
+        }
+
+        struct World world = load_world(worlds, seeds[i]);
+        world.rng_key = rng_key(seeds[i], i);
+        if (is_done)
+        {
+            if (snapshots == NULL)
+            {
+                is_reset = generate_world(&world) == world.agents.n_agents;
+            }
+
+            // worlds that failed to reset keep their flag and write no states
+            if (is_reset)
+            {
+                observe_world(&world, agent_states);
+                dones[i] = 0;
+            }
+        }
+        else
+        {
+            tick_world(&world, agent_states, agent_actions);
+        }
+
+        const uint32_t n_agents = world.agents.n_agents;
+        const size_t n_words = world_state_words(worlds);
+        worlds += n_words;
+        snapshots += (snapshots != NULL) ? 2U + n_words : 0U;
+        agent_states += (size_t)n_agents * AGENT_STATE_SIZE;
+        agent_actions += n_agents;
+    }
+}
+
+// agents do not block paths, as they move out of the way
+[[nodiscard]] static bool is_tile_passable(const enum Tile tile)
+{
+    return !is_tile_blocked(tile) || tile == TILE_FLOOR_OCCUPIED
+        || tile == TILE_OPEN_DOOR_OCCUPIED;
+}
+
+size_t distance_field_workspace_size(uint32_t *world_state)
+{
+    const struct World world = load_world(world_state, 0U);
+    const size_t n_queue_words = (map_tiles(&world.map) + 1U) / 2U;
+    const size_t n_bitboard_words = 4U * bitboard_words(&world.map);
+    return (n_queue_words > n_bitboard_words) ? n_queue_words
+                                              : n_bitboard_words;
+}
+
+static void search_with_queue(const struct Map *map,
+                              uint64_t *workspace,
+                              const uint32_t *goals,
+                              const uint32_t n_goals,
+                              uint32_t *distances)
+{
+    // tiles are queued once, in order of their distance
+    uint32_t *queue = (uint32_t *)workspace;
+    uint32_t n_queued = 0;
+    for (uint32_t i = 0; i < n_goals; i++)
+    {
+        if (distances[goals[i]] != 0)
+        {
+            distances[goals[i]] = 0;
+            queue[n_queued++] = goals[i];
+        }
+    }
+
+    for (uint32_t head = 0; head < n_queued; head++)
+    {
+        const uint32_t pos = queue[head];
+        const uint32_t distance = distances[pos] + 1U;
+        for (uint32_t heading = 0; heading < 4U; heading++)
+        {
+            const uint32_t next =
+                ahead(*map,
+                      (struct Pose){.position = pos,
+                                    .heading = (enum Orientation)heading});
+            if (distances[next] == DISTANCE_UNREACHABLE
+                && is_tile_passable(tile_at(map, next)))
+            {
+                distances[next] = distance;
+                queue[n_queued++] = next;
+            }
+        }
+    }
+}
+
+/* Searches on bitboards in padded coordinates, see `bitboard_word()`, whose
+ * halo rows and columns are never passable: the frontier of each move is the
+ * union of the previous frontier shifted by one row up and down and by one
+ * bit left and right, restricted to passable tiles that were not reached yet.
+ */
+static void search_with_bitboards(const struct Map *map,
+                                  uint64_t *workspace,
+                                  const uint32_t *goals,
+                                  const uint32_t n_goals,
+                                  uint32_t *distances)
+{
+    const size_t n_words = bitboard_words(map);
+    const uint32_t stride = map->blocked_stride;
+    uint64_t *passable = workspace;
+    uint64_t *reached = workspace + n_words;
+    uint64_t *frontier = workspace + (2U * n_words);
+    uint64_t *next_frontier = workspace + (3U * n_words);
+    for (size_t i = 0; i < 4U * n_words; i++)
+    {
+        workspace[i] = 0U;
+    }
+
+    for (uint32_t row = 0; row < map->n_rows; row++)
+    {
+        const uint32_t row_start =
+            ((row + map->padding) * map->stride) + map->padding;
+        for (uint32_t pos = row_start; pos < row_start + map->n_cols; pos++)
+        {
+            if (is_tile_passable(tile_at(map, pos)))
+            {
+                set_bitboard_bit(map, passable, pos, 1U);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < n_goals; i++)
+    {
+        distances[goals[i]] = 0;
+        set_bitboard_bit(map, reached, goals[i], 1U);
+        set_bitboard_bit(map, frontier, goals[i], 1U);
+    }
+
+    const uint32_t first_row = BITBOARD_HALO;
+    const uint32_t last_row = BITBOARD_HALO + map->n_rows;
+    bool is_expanding = n_goals != 0;
+    for (uint32_t distance = 1U; is_expanding; distance++)
+    {
+        is_expanding = false;
+        for (uint32_t row = first_row; row < last_row; row++)
+        {
+            const uint64_t *above = frontier + ((size_t)(row - 1U) * stride);
+            const uint64_t *middle = frontier + ((size_t)row * stride);
+            const uint64_t *below = frontier + ((size_t)(row + 1U) * stride);
+            for (uint32_t word = 0; word < stride; word++)
+            {
+                const size_t idx = ((size_t)row * stride) + word;
+                const uint64_t from_left =
+                    (middle[word] << 1U)
+                    | ((word != 0) ? middle[word - 1U] >> (BITS_PER_WORD - 1U)
+                                   : 0U);
+                const uint64_t from_right = (middle[word] >> 1U)
+                    | ((word + 1U < stride)
+                           ? middle[word + 1U] << (BITS_PER_WORD - 1U)
+                           : 0U);
+                const uint64_t neighbors =
+                    above[word] | below[word] | from_left | from_right;
+                uint64_t bits = neighbors & passable[idx] & ~reached[idx];
+                next_frontier[idx] = bits;
+                reached[idx] |= bits;
+                is_expanding = is_expanding || bits != 0;
+
+                for (; bits != 0; bits &= bits - 1U)
+                {
+                    const uint32_t col = (word * BITS_PER_WORD)
+                        + count_trailing_zeros64(bits);
+                    const uint32_t pos =
+                        ((row - BITBOARD_HALO + map->padding) * map->stride)
+                        + col - BITBOARD_HALO + map->padding;
+                    distances[pos] = distance;
+                }
+            }
+        }
+
+        uint64_t *swap = frontier;
+        frontier = next_frontier;
+        next_frontier = swap;
+    }
+}
+
+// moves to the first neighbor that is one move closer to a goal
+static void write_flow(const struct Map *map,
+                       const uint32_t *distances,
+                       uint32_t *flow)
+{
+    const size_t n_tiles = map_tiles(map);
+    for (uint32_t pos = 0; pos < n_tiles; pos++)
+    {
+        const uint32_t distance = distances[pos];
+        flow[pos] = ACTION_NONE;
+        for (uint32_t heading = 0;
+             heading < 4U && distance != 0 && distance != DISTANCE_UNREACHABLE;
+             heading++)
+        {
+            const uint32_t next =
+                ahead(*map,
+                      (struct Pose){.position = pos,
+                                    .heading = (enum Orientation)heading});
+            if (distances[next] + 1U == distance)
+            {
+                flow[pos] = ACTION_MOVE_UP + heading;
+                break;
+            }
+        }
+    }
+}
+
+void distance_field(
+    uint32_t *world_state, // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *workspace,
+    const uint32_t *goals,
+    const uint32_t n_goals,
+    uint32_t *distances,   // NOLINT(bugprone-easily-swappable-parameters)
+    uint32_t *flow,
+    const enum SearchMethod method)
+{
+    struct World world = load_world(world_state, 0U);
+    world.map.blocked_stride = bitboard_stride(world.map.n_cols);
+    const struct Map *map = &world.map;
+
+    const size_t n_tiles = map_tiles(map);
+    for (size_t i = 0; i < n_tiles; i++)
+    {
+        distances[i] = DISTANCE_UNREACHABLE;
+    }
+
+    if (method == SEARCH_BITBOARD)
+    {
+        search_with_bitboards(map, workspace, goals, n_goals, distances);
+    }
+    else
+    {
+        search_with_queue(map, workspace, goals, n_goals, distances);
+    }
+
+    if (flow != NULL)
+    {
+        write_flow(map, distances, flow);
+    }
+}
+
+/* Layout of a path cache:
+ *  - word 0: `PATH_CACHE_VERSION`,
+ *  - word 1: number of agents,
+ *  - word 2: maximum number of tiles per path,
+ * followed by one record per agent: its goal or `NO_GOAL`, the number of
+ * tiles of its path, the tiles from the far end to the agent and the tiles
+ * of the map at these positions when the path was searched, as written by
+ * `unblock_tile()`.
+ */
+struct PathRecord
+{
+    uint32_t *goal;
+    uint32_t *n_tiles;
+    uint32_t *tiles;
+    enum Tile *planned;
+};
+
+[[nodiscard]] static size_t path_record_words(const uint32_t max_length)
+{
+    return 2U + max_length + ((max_length + 3U) / 4U);
+}
+
+[[nodiscard]] static struct PathRecord path_record(uint32_t *path_cache,
+                                                   const uint32_t idx)
+{
+    const uint32_t max_length = path_cache[2];
+    uint32_t *record = path_cache + PATH_CACHE_HEADER_SIZE
+        + ((size_t)idx * path_record_words(max_length));
+    return (struct PathRecord){
+        .goal = record,
+        .n_tiles = record + 1U,
+        .tiles = record + 2U,
+        .planned = (enum Tile *)(record + 2U + max_length)};
+}
+
+size_t path_cache_size(uint32_t *world_state, const uint32_t max_path_length)
+{
+    const struct World world = load_world(world_state, 0U);
+    return PATH_CACHE_HEADER_SIZE
+        + ((size_t)world.agents.n_agents * path_record_words(max_path_length));
+}
+
+void init_path_cache(uint32_t *world_state,
+                     uint32_t *path_cache,
+                     const uint32_t max_path_length)
+{
+    const struct World world = load_world(world_state, 0U);
+    path_cache[0] = PATH_CACHE_VERSION;
+    path_cache[1] = world.agents.n_agents;
+    path_cache[2] = max_path_length;
+
+    for (uint32_t i = 0; i < world.agents.n_agents; i++)
+    {
+        const struct PathRecord record = path_record(path_cache, i);
+        *record.goal = NO_GOAL;
+        *record.n_tiles = 0U;
+    }
+}
+
+/* A* search state in the workspace: `stamps` holds the id of the last search
+ * that reached each tile, such that costs and parents of other searches are
+ * stale without clearing them, and `heap` the open tiles as a binary min-heap
+ * of the estimated path cost in the upper and the position in the lower half
+ * of each entry.
+ */
+struct PathSearch
+{
+    const struct Map *map;
+    uint32_t *stamps;
+    uint32_t *costs;
+    uint32_t *parents;
+    uint64_t *heap;
+    uint32_t n_open;
+};
+
+size_t path_workspace_size(uint32_t *world_state)
+{
+    const struct World world = load_world(world_state, 0U);
+    const size_t n_tiles = map_tiles(&world.map);
+
+    // a tile enters the heap at most once per neighbor that is expanded
+    return (((3U * n_tiles) + 1U) / 2U) + (4U * n_tiles) + 1U;
+}
+
+static void push_open(struct PathSearch *search, const uint64_t entry)
+{
+    uint64_t *heap = search->heap;
+    uint32_t idx = search->n_open++;
+    while (idx != 0 && heap[(idx - 1U) / 2U] > entry)
+    {
+        heap[idx] = heap[(idx - 1U) / 2U];
+        idx = (idx - 1U) / 2U;
+    }
+    heap[idx] = entry;
+}
+
+[[nodiscard]] static uint64_t pop_open(struct PathSearch *search)
+{
+    uint64_t *heap = search->heap;
+    const uint64_t top = heap[0];
+    const uint64_t last = heap[--search->n_open];
+    const uint32_t n_open = search->n_open;
+
+    uint32_t idx = 0;
+    for (uint32_t child = 1U; child < n_open; child = (2U * idx) + 1U)
+    {
+        if (child + 1U < n_open && heap[child + 1U] < heap[child])
+        {
+            child++;
+        }
+        if (last <= heap[child])
+        {
+            break;
+        }
+        heap[idx] = heap[child];
+        idx = child;
+    }
+    heap[idx] = last;
+
+    return top;
+}
+
+[[nodiscard]] static uint32_t manhattan_distance(const struct Map *map,
+                                                 const uint32_t from,
+                                                 const uint32_t to)
+{
+    const uint32_t from_row = from / map->stride;
+    const uint32_t from_col = from % map->stride;
+    const uint32_t to_row = to / map->stride;
+    const uint32_t to_col = to % map->stride;
+    return ((from_row > to_row) ? from_row - to_row : to_row - from_row)
+        + ((from_col > to_col) ? from_col - to_col : to_col - from_col);
+}
+
+/* Searches a path from `start` to `goal` and writes the tiles of up to the
+ * first `max_length` steps to `record`, returning whether there is a path.
+ */
+[[nodiscard]] static bool find_path(struct PathSearch *search,
+                                    const uint32_t id,
+                                    const uint32_t start,
+                                    const uint32_t goal,
+                                    const uint32_t max_length,
+                                    const struct PathRecord *record)
+{
+    const struct Map *map = search->map;
+    search->stamps[start] = id;
+    search->costs[start] = 0U;
+    search->parents[start] = start;
+    search->n_open = 0U;
+    push_open(search,
+              ((uint64_t)manhattan_distance(map, start, goal) << 32U) | start);
+
+    bool is_found = false;
+    while (search->n_open != 0 && !is_found)
+    {
+        const uint64_t entry = pop_open(search);
+        const uint32_t pos = (uint32_t)entry;
+        const uint32_t cost = search->costs[pos];
+        is_found = pos == goal;
+        if ((entry >> 32U) != cost + manhattan_distance(map, pos, goal))
+        {
+            continue; // reached again at a lower cost
+        }
+
+        for (uint32_t heading = 0; heading < 4U && !is_found; heading++)
+        {
+            const struct Pose pose = {.position = pos,
+                                      .heading = (enum Orientation)heading};
+            const uint32_t next = ahead(*map, pose);
+            const enum Tile tile = tile_at(map, next);
+            if (next == pos
+                || (!is_tile_passable(tile) && tile != TILE_CLOSED_DOOR))
+            {
+                continue;
+            }
+
+            const uint32_t next_cost =
+                cost + ((tile == TILE_CLOSED_DOOR) ? PATH_DOOR_COST : 1U);
+            if (search->stamps[next] != id || next_cost < search->costs[next])
+            {
+                search->stamps[next] = id;
+                search->costs[next] = next_cost;
+                search->parents[next] = pos;
+                const uint32_t estimate =
+                    next_cost + manhattan_distance(map, next, goal);
+                push_open(search, ((uint64_t)estimate << 32U) | next);
+            }
+        }
+    }
+
+    if (!is_found)
+    {
+        return false;
+    }
+
+    uint32_t length = 1U;
+    for (uint32_t pos = goal; pos != start; pos = search->parents[pos])
+    {
+        length++;
+    }
+
+    // keeps the tiles closest to the agent
+    uint32_t pos = goal;
+    for (uint32_t i = max_length; i < length; i++)
+    {
+        pos = search->parents[pos];
+    }
+
+    const uint32_t n_tiles = (length < max_length) ? length : max_length;
+    for (uint32_t i = 0; i < n_tiles; i++)
+    {
+        record->tiles[i] = pos;
+        record->planned[i] = unblock_tile(tile_at(map, pos));
+        pos = search->parents[pos];
+    }
+    *record->goal = goal;
+    *record->n_tiles = n_tiles;
+
+    return true;
+}
+
+/* Returns whether agent at `pos` still follows its path to `goal`, where
+ * the path is shortened by the tile the agent left.
+ */
+[[nodiscard]] static bool follows_path(const struct Map *map,
+                                       const struct PathRecord *record,
+                                       const uint32_t pos,
+                                       const uint32_t goal)
+{
+    uint32_t n_tiles = *record->n_tiles;
+    if (*record->goal != goal)
+    {
+        return false;
+    }
+
+    if (n_tiles >= 2U && record->tiles[n_tiles - 2U] == pos)
+    {
+        n_tiles--;
+        *record->n_tiles = n_tiles;
+    }
+
+    if (n_tiles < 2U || record->tiles[n_tiles - 1U] != pos)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i + 1U < n_tiles; i++)
+    {
+        const enum Tile tile = unblock_tile(tile_at(map, record->tiles[i]));
+        const enum Tile planned = record->planned[i];
+        if (tile != planned
+            && (planned != unblock_tile(TILE_CLOSED_DOOR)
+                || tile != unblock_tile(TILE_OPEN_DOOR)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// returns the action of agent `idx` to step onto the adjacent tile `next`
+[[nodiscard]] static enum Action
+path_action(const struct World *world, const uint32_t idx, const uint32_t next)
+{
+    const uint32_t pos = world->agents.positions[idx];
+    const enum Orientation orientation = world->agents.orientations[idx];
+    for (uint32_t heading = 0; heading < 4U; heading++)
+    {
+        const struct Pose pose = {.position = pos,
+                                  .heading = (enum Orientation)heading};
+        if (ahead(world->map, pose) != next)
+        {
+            continue;
+        }
+
+        if (tile_at(&world->map, next) != TILE_CLOSED_DOOR)
+        {
+            return (enum Action)(ACTION_MOVE_UP + heading);
+        }
+
+        // turns such that the agent faces the door, see `turn()`
+        return (heading == orientation)
+            ? ACTION_OPEN_DOOR
+            : (enum Action)((heading + 4U - orientation) % 4U);
+    }
+
+    return ACTION_NONE;
+}
+
+uint32_t next_path_actions(
+    uint32_t *world_state, // NOLINT(bugprone-easily-swappable-parameters)
+    uint32_t *path_cache,  // NOLINT(bugprone-easily-swappable-parameters)
+    uint64_t *workspace,
+    const uint32_t *requests,
+    const uint32_t n_requests,
+    uint32_t *actions)
+{
+    const struct World world = load_world(world_state, 0U);
+    const size_t n_tiles = map_tiles(&world.map);
+    uint32_t *stamps = (uint32_t *)workspace;
+    struct PathSearch search = {
+        .map = &world.map,
+        .stamps = stamps,
+        .costs = stamps + n_tiles,
+        .parents = stamps + (2U * n_tiles),
+        .heap = workspace + (((3U * n_tiles) + 1U) / 2U)};
+
+    uint32_t n_searches = 0;
+    for (uint32_t i = 0; i < n_requests; i++)
+    {
+        const uint32_t idx = requests[2U * i];
+        const uint32_t goal = requests[(2U * i) + 1U];
+        const uint32_t pos = world.agents.positions[idx];
+        const struct PathRecord record = path_record(path_cache, idx);
+        actions[i] = ACTION_NONE;
+        if (pos == goal || follows_path(&world.map, &record, pos, goal))
+        {
+            if (pos != goal)
+            {
+                const uint32_t next = record.tiles[*record.n_tiles - 2U];
+                actions[i] = path_action(&world, idx, next);
+            }
+            continue;
+        }
+
+        // stamps of earlier calls are stale as well
+        if (n_searches == 0)
+        {
+            for (size_t j = 0; j < n_tiles; j++)
+            {
+                stamps[j] = 0U;
+            }
+        }
+
+        n_searches++;
+        if (find_path(&search, n_searches, pos, goal, path_cache[2], &record))
+        {
+            const uint32_t next = record.tiles[*record.n_tiles - 2U];
+            actions[i] = path_action(&world, idx, next);
+        }
+        else
+        {
+            *record.goal = NO_GOAL;
+        }
+    }
+
+    return n_searches;
+}
+
+/* Layout of an exploration memory (64-bit words):
+ *  - word 0: `EXPLORATION_VERSION`,
+ *  - word 1: number of groups,
+ *  - word 2: maximum number of chunks per group,
+ *  - word 3: number of slots per group, a power of two,
+ * followed by the memory of each group: the number of chunks it holds and
+ * its slots. Each slot of `SLOT_WORDS` words consists of the index of its
+ * chunk plus 1 (0 if the slot is free), the bitset of explored tiles and the
+ * tiles of the chunk as last seen, in row-major order.
+ */
+[[nodiscard]] static uint64_t exploration_slots(const uint32_t max_chunks)
+{
+    // keeps a quarter of the slots free for short probe sequences
+    const uint64_t min_slots = (uint64_t)max_chunks + (max_chunks / 3U) + 1U;
+    uint64_t n_slots = 1U;
+    while (n_slots < min_slots)
+    {
+        n_slots *= 2U;
+    }
+
+    return n_slots;
+}
+
+[[nodiscard]] static size_t group_memory_words(const uint64_t n_slots)
+{
+    return 1U + ((size_t)n_slots * SLOT_WORDS);
+}
+
+size_t exploration_memory_size(const uint32_t n_groups,
+                               const uint32_t max_chunks)
+{
+    const uint64_t n_slots = exploration_slots(max_chunks);
+    return EXPLORATION_HEADER_SIZE
+        + ((size_t)n_groups * group_memory_words(n_slots));
+}
+
+void init_exploration_memory(uint64_t *memory,
+                             const uint32_t n_groups,
+                             const uint32_t max_chunks)
+{
+    memory[0] = EXPLORATION_VERSION;
+    memory[1] = n_groups;
+    memory[2] = max_chunks;
+    memory[3] = exploration_slots(max_chunks);
+
+    const size_t n_words = exploration_memory_size(n_groups, max_chunks);
+    for (size_t i = EXPLORATION_HEADER_SIZE; i < n_words; i++)
+    {
+        memory[i] = 0U;
+    }
+}
+
+// returns the offset of the memory of `group` in an exploration memory
+[[nodiscard]] static size_t group_offset(const uint64_t *memory,
+                                         const uint32_t group)
+{
+    return EXPLORATION_HEADER_SIZE
+        + ((size_t)group * group_memory_words(memory[3]));
+}
+
+/* Returns the slot of `chunk` in the memory of a group, which is either the
+ * slot holding it or the free slot to hold it.
+ */
+[[nodiscard]] static uint64_t *chunk_slot(const uint64_t *memory,
+                                          uint64_t *group_memory,
+                                          const uint32_t chunk)
+{
+    const uint64_t mask = memory[3] - 1U;
+    uint64_t idx = ((uint64_t)chunk * 0x9E3779B97F4A7C15ULL) >> 32U;
+    for (;; idx++)
+    {
+        uint64_t *slot = group_memory + 1U + ((idx & mask) * SLOT_WORDS);
+        if (slot[0] == 0U || slot[0] == (uint64_t)chunk + 1U)
+        {
+            return slot;
+        }
+    }
+}
+
+uint32_t update_exploration(
+    uint32_t *world_state,
+    uint64_t *memory,
+    const uint32_t *groups, // NOLINT(bugprone-easily-swappable-parameters)
+    const uint32_t *agent_states)
+{
+    const struct World world = load_world(world_state, 0U);
+    const struct Map *map = &world.map;
+    const uint32_t n_chunk_cols = (map->n_cols + CHUNK_SIDE - 1U) / CHUNK_SIDE;
+
+    uint32_t n_dropped = 0;
+    for (uint32_t idx = 0; idx < world.agents.n_agents; idx++)
+    {
+        const uint32_t group = (groups != NULL) ? groups[idx] : idx;
+        uint64_t *group_memory = memory + group_offset(memory, group);
+        const uint32_t *agent_state =
+            agent_states + ((size_t)idx * AGENT_STATE_SIZE);
+        const enum Tile *fov = (const enum Tile *)(agent_state + 4U);
+
+        // the window of the FoV in map orientation, see `fill_agent_fov()`
+        const uint32_t pos = world.agents.positions[idx];
+        const struct FovFrame frame = fov_frame(world.agents.orientations[idx]);
+        const uint32_t first_row =
+            (pos / map->stride) - map->padding + frame.row_offset;
+        const uint32_t first_col =
+            (pos % map->stride) - map->padding + frame.col_offset;
+
+        uint32_t chunk = UINT32_MAX;
+        uint64_t *slot = NULL;
+        for (uint32_t i = 0; i < FOV_SIZE * FOV_SIZE; i++)
+        {
+            const uint32_t row = first_row + (i / FOV_SIZE);
+            const uint32_t col = first_col + (i % FOV_SIZE);
+            const enum Tile tile =
+                fov[(frame.row_step * (i / FOV_SIZE))
+                    + (frame.col_step * (i % FOV_SIZE)) + frame.origin];
+            if (tile == TILE_HIDDEN || row >= map->n_rows || col >= map->n_cols)
+            {
+                continue;
+            }
+
+            const uint32_t tile_chunk =
+                ((row / CHUNK_SIDE) * n_chunk_cols) + (col / CHUNK_SIDE);
+            if (tile_chunk != chunk)
+            {
+                chunk = tile_chunk;
+                slot = chunk_slot(memory, group_memory, chunk);
+                if (slot[0] == 0U && group_memory[0] < memory[2])
+                {
+                    slot[0] = (uint64_t)chunk + 1U;
+                    group_memory[0]++;
+                }
+            }
+
+            if (slot[0] == 0U)
+            {
+                n_dropped++;
+                continue;
+            }
+
+            const uint32_t tile_idx =
+                ((row % CHUNK_SIDE) * CHUNK_SIDE) + (col % CHUNK_SIDE);
+            slot[1] |= 1ULL << tile_idx;
+            ((enum Tile *)(slot + 2U))[tile_idx] = tile;
+        }
+    }
+
+    return n_dropped;
+}
+
+uint32_t recall_map(uint32_t *world_state,
+                    const uint64_t *memory,
+                    const uint32_t group,
+                    uint8_t *tiles)
+{
+    const struct World world = load_world(world_state, 0U);
+    const uint32_t n_rows = world.map.n_rows;
+    const uint32_t n_cols = world.map.n_cols;
+    for (size_t i = 0; i < (size_t)n_rows * n_cols; i++)
+    {
+        tiles[i] = TILE_HIDDEN;
+    }
+
+    const uint32_t n_chunk_cols = (n_cols + CHUNK_SIDE - 1U) / CHUNK_SIDE;
+    const uint64_t *slots = memory + group_offset(memory, group) + 1U;
+    uint32_t n_explored = 0;
+    for (uint64_t i = 0; i < memory[3]; i++)
+    {
+        const uint64_t *slot = slots + (i * SLOT_WORDS);
+        if (slot[0] == 0U)
+        {
+            continue;
+        }
+
+        const uint32_t chunk = (uint32_t)(slot[0] - 1U);
+        const uint32_t row = (chunk / n_chunk_cols) * CHUNK_SIDE;
+        const uint32_t col = (chunk % n_chunk_cols) * CHUNK_SIDE;
+        const enum Tile *chunk_tiles = (const enum Tile *)(slot + 2U);
+        for (uint64_t bits = slot[1]; bits != 0; bits &= bits - 1U)
+        {
+            const uint32_t tile_idx = count_trailing_zeros64(bits);
+            const size_t map_idx =
+                ((size_t)(row + (tile_idx / CHUNK_SIDE)) * n_cols) + col
+                + (tile_idx % CHUNK_SIDE);
+            tiles[map_idx] = chunk_tiles[tile_idx];
+            n_explored++;
+        }
+    }
+
+    return n_explored;
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,549 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define WORLD_STATE_PADDED 0x80010001U
+#define MAP_HALO (FOV_SIZE - 1U)
+#define AGENT_STATE_VERSION 0x00010001U
+#ifndef FOV_SIZE
+#define FOV_SIZE 5U
+#endif
+#define FOV_SELF_IDX ((FOV_SIZE * (FOV_SIZE - 1U)) + (FOV_SIZE / 2U))
+#define AGENT_STATE_SIZE (4U + (((FOV_SIZE * FOV_SIZE) + 3U) / 4U))
+#define SCRATCH_VERSION 0x00010001U
+#define SNAPSHOT_VERSION 0x00010001U
+#define FORK_VERSION 0x00010001U
+#define FORK_FULL UINT32_MAX
+#define UNDO_LOG_VERSION 0x00010001U
+#define SHADOWCAST_MAX_RADIUS 32U
+#define PACKED_STATE_VERSION 0x00010001U
+#define PACKED_STATE_HEADER_SIZE 4U
+#define PLANE_CHANNELS 6U
+#define FRAME_STACK_VERSION 0x00010001U
+#define DISTANCE_UNREACHABLE UINT32_MAX
+#define PATH_CACHE_VERSION 0x00010001U
+#define EXPLORATION_VERSION 0x00010001U
+
+#if FOV_SIZE < 3U || FOV_SIZE > 11U || FOV_SIZE % 2U == 0U
+#error "FOV_SIZE must be one of 3, 5, 7, 9, and 11"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+enum Action : uint32_t
+{
+    ACTION_NONE = 0,
+    ACTION_TURN_90 = 1,
+    ACTION_TURN_180 = 2,
+    ACTION_TURN_270 = 3,
+    ACTION_MOVE_UP = 4,
+    ACTION_MOVE_RIGHT = 5,
+    ACTION_MOVE_DOWN = 6,
+    ACTION_MOVE_LEFT = 7,
+    ACTION_OPEN_DOOR = 8,
+    ACTION_CLOSE_DOOR = 9,
+};
+
+enum Tile : uint8_t
+{
+    TILE_HIDDEN = 0x00,
+    TILE_WALL = 0x11,
+    TILE_FLOOR = 0x02,
+    TILE_FLOOR_OCCUPIED = 0x12,
+    TILE_OPEN_DOOR = 0x03,
+    TILE_OPEN_DOOR_OCCUPIED = 0x13,
+    TILE_CLOSED_DOOR = 0x33,
+    TILE_VOID = 0x10, // halo of padded maps, blocked but hidden to agents
+};
+
+// 3-bit codes of the tiles of packed agent states
+enum PackedTile : uint32_t
+{
+    PACKED_TILE_HIDDEN = 0,
+    PACKED_TILE_CLOSED_DOOR = 1,
+    PACKED_TILE_FLOOR = 2,
+    PACKED_TILE_OPEN_DOOR = 3,
+    PACKED_TILE_VOID = 4,
+    PACKED_TILE_WALL = 5,
+    PACKED_TILE_FLOOR_OCCUPIED = 6,
+    PACKED_TILE_OPEN_DOOR_OCCUPIED = 7,
+};
+
+/* Channels of observation planes, where occupied floors and open doors are
+ * hot in `PLANE_OCCUPIED` as well.
+ */
+enum PlaneChannel : uint32_t
+{
+    PLANE_HIDDEN = 0,
+    PLANE_WALL = 1,
+    PLANE_FLOOR = 2,
+    PLANE_OCCUPIED = 3,
+    PLANE_OPEN_DOOR = 4,
+    PLANE_CLOSED_DOOR = 5,
+};
+
+enum Orientation : uint32_t
+{
+    ORIENTATION_UP,
+    ORIENTATION_RIGHT,
+    ORIENTATION_DOWN,
+    ORIENTATION_LEFT,
+};
+
+enum ScratchFeature : uint32_t
+{
+    SCRATCH_BITBOARD = 1U << 0U,
+    SCRATCH_CLAIM_TABLE = 1U << 1U,
+    SCRATCH_OBSERVATION_CACHE = 1U << 2U,
+    SCRATCH_AGENT_GRID = 1U << 3U,
+    SCRATCH_PACKED_STATES = 1U << 4U,
+};
+
+// searches of `distance_field()`
+enum SearchMethod : uint32_t
+{
+    SEARCH_QUEUE = 0,    // breadth-first search with a queue of tiles
+    SEARCH_BITBOARD = 1, // frontiers of whole rows of tiles per word
+};
+
+/* World states come in one of two layouts (one word per entry, tiles are one
+ * byte each):
+ *  - legacy: `n_agents`, positions, orientations, `n_rows`, `n_cols`, tiles,
+ *  - padded: `WORLD_STATE_PADDED` followed by the legacy layout, where the
+ *    map is surrounded by a halo of `MAP_HALO` rows and columns of
+ *    `TILE_VOID` and positions refer to the padded map. Hence, the map holds
+ *    `(n_rows + 2 * MAP_HALO) * (n_cols + 2 * MAP_HALO)` tiles and agents
+ *    never look or move beyond its bounds.
+ *
+ * Each agent state consists of `AGENT_STATE_SIZE` words: `AGENT_STATE_VERSION`,
+ * the number of rows and columns of the FoV (`FOV_SIZE`), the index of the
+ * agent within the FoV (`FOV_SELF_IDX`) and the tiles of the FoV.
+ *
+ * `FOV_SIZE` is fixed at build time and defaults to 5, e.g., `make fov` builds
+ * engines for FoVs of 3, 7, 9, and 11 tiles per side, whose occlusion rules are
+ * generated by `occlusion_gen.c`.
+ */
+
+// Returns the size of an agent state in words.
+[[nodiscard]] uint32_t agent_state_size(void);
+
+/* Applies one action per agent in a seeded random order and writes the
+ * agent state of each agent to `agent_states`. Random numbers are drawn from
+ * counter-based streams keyed by `seed`, e.g., the tick number, such that
+ * ticks are reproducible from their seed alone.
+ */
+void tick(uint32_t *world_state,
+          uint32_t *agent_states,
+          const uint32_t *agent_actions,
+          uint32_t seed);
+
+/* Advances `n_worlds` independent worlds by one tick each.
+ *
+ * All buffers are the per-world buffers of `tick()` laid out back to back:
+ *  - `worlds`: world states in either layout, each padded to a whole number
+ *    of words, e.g., a legacy world `i + 1` starts
+ *    `3 + 2 * n_agents + ceil(n_rows * n_cols / 4)` words after world `i`,
+ *  - `agent_states`: `n_agents * AGENT_STATE_SIZE` words per world,
+ *  - `agent_actions`: `n_agents` words per world,
+ *  - `seeds`: one word per world.
+ *
+ * The random streams of world `i` are keyed by `seeds[i]` and `i`, hence
+ * worlds sharing a seed still act in independent orders.
+ */
+void tick_batch(uint32_t *worlds,
+                uint32_t n_worlds,
+                uint32_t *agent_states,
+                const uint32_t *agent_actions,
+                const uint32_t *seeds);
+
+/* Sets the number of threads, including the calling thread, that share the
+ * work of a tick and returns the number of threads actually started. Builds
+ * without `ENGINE_THREADS` always run on the calling thread. The setting
+ * applies to all worlds of the process and results do not depend on it.
+ */
+uint32_t set_thread_count(uint32_t n_threads);
+
+/* Returns the size in words of the padded copy of a world state in legacy
+ * layout.
+ */
+[[nodiscard]] size_t padded_world_state_size(uint32_t *world_state);
+
+/* Converts a world state in legacy layout into a padded world state of
+ * `padded_world_state_size()` words.
+ */
+void pad_world_state(uint32_t *world_state, uint32_t *padded_state);
+
+/* Returns the size in words of the scratch buffer of the world for the given
+ * set of features (`enum ScratchFeature`).
+ */
+[[nodiscard]] size_t scratch_size(uint32_t *world_state, uint32_t features);
+
+/* Initializes the scratch buffer of the world for the given set of features.
+ * The scratch buffer must hold `scratch_size()` words and has to be
+ * re-initialized whenever the world state is modified by the host.
+ */
+void init_scratch(uint32_t *world_state, uint64_t *scratch, uint32_t features);
+
+/* Same as `tick()` but uses and maintains the scratch buffer of the world as
+ * initialized by `init_scratch()`.
+ *
+ * With `SCRATCH_CLAIM_TABLE`, all actions are resolved simultaneously against
+ * the world at the start of the tick instead of one after another: agents
+ * claim the tile they move into or the door they open or close, and of all
+ * claims on a tile only the one of the agent that comes first in the seeded
+ * order succeeds. Tiles that are occupied at the start of the tick cannot be
+ * claimed, hence agents never follow each other or swap places in one tick.
+ *
+ * With `SCRATCH_OBSERVATION_CACHE`, only the agent states of agents whose pose
+ * changed or whose FoV window contains a tile changed since their last update
+ * are rewritten. Hence, `agent_states` has to be the buffer of the previous
+ * tick of the world.
+ *
+ * With `SCRATCH_PACKED_STATES`, agent states are written as packed states of
+ * `packed_state_size()` words each, which hold the tiles of the FoV only as
+ * `enum PackedTile` codes of 3 bits, 10 per word and starting at the least
+ * significant bits. The header, which is the same in every tick, is written
+ * once by `packed_state_header()`.
+ */
+void tick_with_scratch(uint32_t *world_state,
+                       uint64_t *scratch,
+                       uint32_t *agent_states,
+                       const uint32_t *agent_actions,
+                       uint32_t seed);
+
+/* Returns the size in words of a snapshot of the world.
+ *
+ * A snapshot consists of `SNAPSHOT_VERSION`, the size of the world state in
+ * bytes and a copy of the world state, i.e., the positions and orientations
+ * of all agents and all tiles including the state of doors.
+ */
+[[nodiscard]] size_t snapshot_size(uint32_t *world_state);
+
+// Saves the world into a snapshot of `snapshot_size()` words.
+void snapshot_world(uint32_t *world_state, uint32_t *snapshot);
+
+/* Restores the world saved in `snapshot` with a single copy, e.g., to reset an
+ * episode without rebuilding its world state. If `scratch` is not NULL, the
+ * scratch buffer of the world is re-initialized for its enabled features.
+ *
+ * Returns false and leaves the world unchanged if `snapshot` does not start
+ * with `SNAPSHOT_VERSION`, or if it saved a world state of another size.
+ */
+[[nodiscard]] bool restore_world(uint32_t *world_state,
+                                 uint64_t *scratch,
+                                 const uint32_t *snapshot);
+
+/* Returns the size in words of a fork of the world that can own up to
+ * `n_chunks` chunks of 64 tiles. Forks of forks have the same size as forks
+ * of the original world.
+ */
+[[nodiscard]] size_t fork_size(uint32_t *world_state, uint32_t n_chunks);
+
+/* Forks the world into a buffer of `fork_size()` words, e.g., to branch a
+ * rollout of a tree search. The fork copies the agents but shares the tiles
+ * with the world, and copies a chunk of tiles only when a tick of the fork
+ * writes to it for the first time. Hence, the world must neither be modified
+ * nor be freed as long as the fork is in use.
+ *
+ * The world state of the fork without its tiles is stored from word 5 of the
+ * fork, i.e., the host may read the positions and orientations of its agents
+ * from there.
+ */
+void fork_world(uint32_t *world_state, uint64_t *fork, uint32_t n_chunks);
+
+/* Same as `fork_world()` but forks a fork, which shares the chunks owned by
+ * `parent`. Hence, `parent` must neither be ticked nor be freed as long as the
+ * fork is in use.
+ */
+void fork_fork(uint64_t *parent, uint64_t *fork, uint32_t n_chunks);
+
+/* Same as `tick()` but ticks a fork and returns the number of chunks the fork
+ * can still take ownership of. A tick takes ownership of at most
+ * `2 * n_agents` chunks that the fork does not own yet. If fewer chunks are
+ * left, the fork is not ticked and `FORK_FULL` is returned.
+ */
+uint32_t tick_fork(uint64_t *fork,
+                   uint32_t *agent_states,
+                   const uint32_t *agent_actions,
+                   uint32_t seed);
+
+/* Returns the size in words of an undo log of the world that records up to
+ * `n_ticks` ticks.
+ */
+[[nodiscard]] size_t undo_log_size(uint32_t *world_state, uint32_t n_ticks);
+
+// Initializes an empty undo log of `undo_log_size()` words.
+void init_undo_log(uint32_t *world_state, uint64_t *undo_log, uint32_t n_ticks);
+
+/* Same as `tick_with_scratch()` but records every change of a tile, position
+ * or orientation in the undo log, such that the tick can be reverted by
+ * `untick()`, e.g., to step back during a depth-first search. `scratch` may be
+ * NULL. Returns the number of ticks that can at least still be recorded, where
+ * no tick must be run once it is zero.
+ */
+uint32_t tick_with_undo_log(uint32_t *world_state,
+                            uint64_t *scratch,
+                            uint64_t *undo_log,
+                            uint32_t *agent_states,
+                            const uint32_t *agent_actions,
+                            uint32_t seed);
+
+/* Reverts the last tick recorded in the undo log in time proportional to the
+ * number of its changes and returns the number of ticks that are still
+ * recorded. The agent states written by the tick are not reverted. `scratch`
+ * may be NULL and has to be the one used by `tick_with_undo_log()` otherwise.
+ */
+uint32_t untick(uint32_t *world_state, uint64_t *scratch, uint64_t *undo_log);
+
+/* Writes the ids of all other agents that agent `idx` sees in its occluded
+ * FoV to `agent_ids`, which must hold `FOV_SIZE * FOV_SIZE - 1` words, and
+ * returns their number. Agents are ordered by their tile in the FoV. The
+ * scratch buffer must have been initialized with `SCRATCH_AGENT_GRID`, which
+ * maintains the agent on each tile, and no agents are found otherwise.
+ */
+[[nodiscard]] uint32_t visible_agents(uint32_t *world_state,
+                                      uint64_t *scratch,
+                                      uint32_t idx,
+                                      uint32_t *agent_ids);
+
+// Returns the size of a packed agent state in words.
+[[nodiscard]] uint32_t packed_state_size(void);
+
+/* Writes the `PACKED_STATE_HEADER_SIZE` words that describe packed agent
+ * states: `PACKED_STATE_VERSION`, the number of rows and columns of the FoV
+ * and the index of the agent within the FoV.
+ */
+void packed_state_header(uint32_t *header);
+
+/* Writes the tiles of `n_agents` consecutive agent states, e.g., of `tick()`
+ * or `observe_shadowcast()`, as planes of shape
+ * `[n_agents, PLANE_CHANNELS, rows, columns]` to `planes`, where an entry is 1
+ * iff the tile belongs to the channel (`enum PlaneChannel`) and 0 otherwise.
+ * All states must have the shape given by the header of the first one.
+ */
+void observation_planes_f32(const uint32_t *agent_states,
+                            uint32_t n_agents,
+                            float *planes);
+
+// Same as `observation_planes_f32()` but writes planes of bytes.
+void observation_planes_u8(const uint32_t *agent_states,
+                           uint32_t n_agents,
+                           uint8_t *planes);
+
+/* Returns the size in words of a frame stack of the world that holds the
+ * agent states of the last `n_frames` ticks, where each agent state has
+ * `state_size` words, i.e., `agent_state_size()` or `packed_state_size()`.
+ */
+[[nodiscard]] size_t frame_stack_size(uint32_t *world_state,
+                                      uint32_t n_frames,
+                                      uint32_t state_size);
+
+/* Initializes a frame stack of `frame_stack_size()` words, where all frames
+ * are zero until written.
+ */
+void init_frame_stack(uint32_t *world_state,
+                      uint32_t *frames,
+                      uint32_t n_frames,
+                      uint32_t state_size);
+
+/* Same as `tick_with_scratch()` but writes the agent states to the frame
+ * after the latest one, which overwrites the oldest frame once all frames are
+ * written. Frames are never moved, hence a tick writes the same number of
+ * words as `tick_with_scratch()`, except that agents skipped by the
+ * observation cache copy their agent state from the previous frame, which is
+ * the written frame itself for stacks of a single frame. `scratch` may be
+ * NULL.
+ *
+ * Returns false without ticking if the stack has no frames, or if its state
+ * size or number of agents differs from the agent states of the tick, i.e.,
+ * `packed_state_size()` with `SCRATCH_PACKED_STATES` and `agent_state_size()`
+ * otherwise.
+ */
+[[nodiscard]] bool tick_with_frame_stack(uint32_t *world_state,
+                                         uint64_t *scratch,
+                                         uint32_t *frames,
+                                         const uint32_t *agent_actions,
+                                         uint32_t seed);
+
+/* Returns the agent states of all agents written `age` ticks ago, where
+ * `age < n_frames` and 0 refers to the latest tick, as a view into the frame
+ * stack.
+ */
+[[nodiscard]] uint32_t *frame_stack_frame(uint32_t *frames, uint32_t age);
+
+/* Writes the frames of each agent from the oldest to the latest one to
+ * `stacked`, i.e., `n_frames` agent states per agent.
+ */
+void stack_frames(const uint32_t *frames, uint32_t *stacked);
+
+/* Returns the size in words of an agent state written by
+ * `observe_shadowcast()` for a view radius of `radius` tiles.
+ */
+[[nodiscard]] uint32_t shadowcast_state_size(uint32_t radius);
+
+/* Writes the agent state of each agent as seen within `radius` tiles, where
+ * `1 <= radius <= SHADOWCAST_MAX_RADIUS`, to `agent_states`, which holds
+ * `shadowcast_state_size(radius)` words per agent, e.g., after a tick for
+ * scouting agents that see further than the FoV. The states have the layout
+ * of the agent states of `tick()` with `radius + 1` rows and
+ * `2 * radius + 1` columns: the agent looks up from the center of the last
+ * row. Visibility is computed by symmetric shadowcasting, hence the cost
+ * scales with the number of visible tiles rather than the window area. Nothing
+ * is written if `radius` is out of range.
+ */
+void observe_shadowcast(uint32_t *world_state,
+                        uint32_t radius,
+                        uint32_t *agent_states);
+
+/* Generates a dungeon from `seed` into the map of the world state and places
+ * the agents on distinct random floor tiles facing random directions.
+ *
+ * The map within its outer walls is split recursively (binary space
+ * partitioning) into leaves of 6 to 11 rows and columns. Each leaf holds a
+ * room, and the rooms of consecutive leaves are connected by corridors with
+ * closed doors where they enter a room. At least a tenth of a map of 16 or
+ * more rows and columns is floor. Maps of padded world states get a halo of
+ * `TILE_VOID`, but are otherwise generated the same as in legacy layout.
+ * Runs in time linear in the size of the map.
+ *
+ * Returns the number of placed agents, which is less than `n_agents` only if
+ * the map has fewer floor tiles, in which case the world state is invalid.
+ * Maps with fewer than 4 rows or columns are too small for a room, and 0 is
+ * returned without changing the world state.
+ */
+[[nodiscard]] uint32_t generate_dungeon(uint32_t *world_state, uint32_t seed);
+
+/* Same as `tick_batch()` but first resets each world `i` with `dones[i] != 0`
+ * and clears its flag, such that finished episodes restart within the call
+ * instead of stalling the batch. A world is reset to its snapshot in
+ * `snapshots`, which holds one snapshot per world back to back as written by
+ * `snapshot_world()`, or regenerated by `generate_dungeon()` from the random
+ * streams of the world if `snapshots` is NULL, e.g., world 0 as with
+ * `seeds[0]`. Reset worlds ignore their actions and write the agent states of
+ * the first tick of their new episode. `dones` may be NULL to reset no world.
+ *
+ * A world fails to reset if `restore_world()` rejects its snapshot, in which
+ * case it is left unchanged, or if `generate_dungeon()` cannot place all its
+ * agents, in which case its world state is invalid. Either way, its flag
+ * stays set and its agent states are not written.
+ */
+void tick_batch_with_reset(uint32_t *worlds,
+                           uint32_t n_worlds,
+                           uint32_t *agent_states,
+                           const uint32_t *agent_actions,
+                           const uint32_t *seeds,
+                           uint32_t *dones,
+                           const uint32_t *snapshots);
+
+/* Returns the size in 64-bit words of the workspace of `distance_field()`,
+ * which suffices for either search method.
+ */
+[[nodiscard]] size_t distance_field_workspace_size(uint32_t *world_state);
+
+/* Writes the number of moves from each tile of the map to the nearest of
+ * `n_goals` positions in `goals` to `distances`, one word per tile of the map
+ * including the halo of padded maps, and `DISTANCE_UNREACHABLE` where no goal
+ * can be reached. Walls, closed doors and the halo are impassable, whereas
+ * agents are not, as they move out of the way. If `flow` is not NULL, it
+ * receives one word per tile as well, the `ACTION_MOVE_*` to a neighbor that
+ * is one move closer to a goal, or `ACTION_NONE` on goals and unreachable
+ * tiles, such that any number of agents can follow one shared field.
+ *
+ * `SEARCH_QUEUE` visits each tile once, whereas `SEARCH_BITBOARD` expands
+ * the frontier 64 tiles at a time per move and is faster on open maps with
+ * short distances. Both write the same fields.
+ */
+void distance_field(uint32_t *world_state,
+                    uint64_t *workspace,
+                    const uint32_t *goals,
+                    uint32_t n_goals,
+                    uint32_t *distances,
+                    uint32_t *flow,
+                    enum SearchMethod method);
+
+/* Returns the size in words of a path cache of the world that keeps up to
+ * `max_path_length` tiles of the path of each agent, where
+ * `max_path_length >= 2`.
+ */
+[[nodiscard]] size_t path_cache_size(uint32_t *world_state,
+                                     uint32_t max_path_length);
+
+// Initializes a path cache of `path_cache_size()` words without any paths.
+void init_path_cache(uint32_t *world_state,
+                     uint32_t *path_cache,
+                     uint32_t max_path_length);
+
+// Returns the size in 64-bit words of the workspace of `next_path_actions()`.
+[[nodiscard]] size_t path_workspace_size(uint32_t *world_state);
+
+/* Writes the next action of each of `n_requests` agents towards its goal to
+ * `actions`, where `requests` holds pairs of an agent id and a goal position,
+ * and returns the number of paths searched.
+ *
+ * Paths are searched by A* with the Manhattan distance as heuristic. Agents
+ * move along paths by `ACTION_MOVE_*` regardless of their orientation, and
+ * closed doors on the way cost one more action, as agents turn to face them
+ * with `ACTION_TURN_*` and then use `ACTION_OPEN_DOOR`. Walls and the halo
+ * are impassable, whereas agents are not, as they move out of the way.
+ *
+ * Paths are kept in `path_cache` and followed until the goal of the agent
+ * changes, the agent leaves its path, or a tile on the rest of the path is
+ * edited, e.g., a door on it is closed or a wall is built. Opening doors
+ * never invalidates a path, as it only gets shorter. Agents that reach the
+ * end of a cached prefix of a long path search again. Agents on their goal or
+ * without a path to it get `ACTION_NONE`.
+ */
+uint32_t next_path_actions(uint32_t *world_state,
+                           uint32_t *path_cache,
+                           uint64_t *workspace,
+                           const uint32_t *requests,
+                           uint32_t n_requests,
+                           uint32_t *actions);
+
+/* Returns the size in 64-bit words of the exploration memory of `n_groups`
+ * groups of agents, e.g., teams or single agents, where each group remembers
+ * up to `max_chunks` chunks of 8 x 8 tiles of the map.
+ */
+[[nodiscard]] size_t exploration_memory_size(uint32_t n_groups,
+                                             uint32_t max_chunks);
+
+// Initializes an exploration memory of `exploration_memory_size()` words.
+void init_exploration_memory(uint64_t *memory,
+                             uint32_t n_groups,
+                             uint32_t max_chunks);
+
+/* Adds the tiles seen in `agent_states`, as written by the last tick, to the
+ * memory of the group of each agent, overwriting what was seen before, and
+ * returns the number of seen tiles that did not fit into the memory of their
+ * group. Agent `i` belongs to group `groups[i]`, or group `i` if `groups` is
+ * NULL.
+ *
+ * The memory of a group is a hash table of the chunks it has seen, each with
+ * a bitset of the explored tiles and the tiles as last seen, such that its
+ * size depends on the explored area rather than the size of the map.
+ * `agent_states` holds `AGENT_STATE_SIZE` words per agent, i.e., not packed.
+ */
+uint32_t update_exploration(uint32_t *world_state,
+                            uint64_t *memory,
+                            const uint32_t *groups,
+                            const uint32_t *agent_states);
+
+/* Writes the map as remembered by `group` to `tiles`, one byte per tile of
+ * the map in legacy layout, i.e., without a halo, where unexplored tiles are
+ * `TILE_HIDDEN`, and returns the number of explored tiles.
+ */
+uint32_t recall_map(uint32_t *world_state,
+                    const uint64_t *memory,
+                    uint32_t group,
+                    uint8_t *tiles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENGINE_H
@@ -97,12 +97,12 @@ void test_load_world_with_zero_seed(void)
     const uint32_t seed = 0U;
     const struct World world = load_world(g_world_state, seed);
 
-    TEST_ASSERT_NOT_EQUAL(0U, world.rng_state);
+    TEST_ASSERT_NOT_EQUAL(0U, world.rng_key);
 }
 
 void test_load_world_initializes_world(void)
 {
-    TEST_ASSERT_NOT_EQUAL(0U, g_world.rng_state);
+    TEST_ASSERT_NOT_EQUAL(0U, g_world.rng_key);
 
     TEST_ASSERT_EQUAL_UINT32(2U, g_agents.n_agents);
     ASSERT_AGENT_POSITION(0, 0U);
@@ -522,6 +522,2478 @@ void test_apply_occlusion_hides_occluded_tiles()
     TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, fov, 25);
 }
 
+void test_tick_batch_ticks_every_world(void)
+{
+    enum : uint32_t
+    {
+        n_worlds = 2U,
+        n_agents = 2U,
+        n_states = n_agents * AGENT_STATE_SIZE
+    };
+
+    const size_t world_bytes =
+        (7U * sizeof(uint32_t)) + (size_t)(g_map.n_rows * g_map.n_cols);
+    const size_t world_words = world_state_words(g_world_state);
+    TEST_ASSERT_EQUAL_size_t(18U, world_words);
+
+    uint32_t *worlds = calloc(n_worlds * world_words, sizeof(uint32_t));
+    uint32_t *expected_worlds =
+        calloc(n_worlds * world_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(worlds);
+    TEST_ASSERT_NOT_NULL(expected_worlds);
+
+    for (uint32_t i = 0; i < n_worlds; i++)
+    {
+        memcpy(worlds + (i * world_words), g_world_state, world_bytes);
+        memcpy(expected_worlds + (i * world_words), g_world_state, world_bytes);
+    }
+
+    const uint32_t actions[] = {
+        ACTION_MOVE_DOWN, ACTION_NONE, ACTION_TURN_90, ACTION_MOVE_RIGHT};
+    const uint32_t seeds[] = {1U, 2U};
+
+    uint32_t states[n_worlds * n_states] = {};
+    uint32_t expected_states[n_worlds * n_states] = {};
+
+    tick_batch(worlds, n_worlds, states, actions, seeds);
+
+    // each world draws from its own random streams
+    for (uint32_t i = 0; i < n_worlds; i++)
+    {
+        struct World world =
+            load_world(expected_worlds + (i * world_words), seeds[i]);
+        world.rng_key = rng_key(seeds[i], i);
+        tick_world(&world,
+                   expected_states + (i * n_states),
+                   actions + (i * n_agents));
+    }
+
+    // world 0: agent 0 moved down
+    TEST_ASSERT_EQUAL_UINT32(7U, worlds[1]);
+
+    // world 1: agent 0 turned and agent 1 moved right
+    TEST_ASSERT_EQUAL_UINT32(ORIENTATION_RIGHT, worlds[world_words + 3U]);
+    TEST_ASSERT_EQUAL_UINT32(2U, worlds[world_words + 2U]);
+
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected_worlds, worlds, n_worlds * world_words);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected_states, states, n_worlds * n_states);
+
+    free(expected_worlds);
+    free(worlds);
+}
+
+[[nodiscard]] static uint32_t reference_occlusion_mask(const uint32_t blocked)
+{
+    uint32_t m[25]; // NOLINT(readability-identifier-length)
+    for (uint32_t i = 0; i < 25U; i++)
+    {
+        m[i] = (blocked >> i) & 1U;
+    }
+
+    // original boolean cascade of apply_occlusion
+    m[0] = m[11] || m[17] || (m[6] && (m[5] || m[16]));
+    m[1] = m[12] || m[17];
+    m[2] = m[7] || m[12] || m[17];
+    m[3] = m[12] || m[17];
+    m[4] = m[13] || m[17] || (m[8] && (m[9] || m[18]));
+    m[5] = m[11] || m[16] || m[17];
+    m[6] = m[17] || (m[12] && (m[11] || m[16]));
+    m[7] = m[12] || m[17];
+    m[8] = m[17] || (m[12] && (m[13] || m[18]));
+    m[9] = m[13] || m[17] || m[18];
+    m[10] = m[16] || ((m[11] || m[17]) && (m[15] || m[21]));
+    m[11] = m[16] && m[17];
+    m[12] = m[17];
+    m[14] = m[18] || ((m[13] || m[17]) && (m[19] || m[23]));
+    m[13] = m[17] && m[18];
+    m[15] = m[21];
+    m[16] = m[17] && m[21];
+    m[18] = m[17] && m[23];
+    m[19] = m[23];
+    m[20] = m[21];
+    m[22] = 0U;
+    m[24] = m[23];
+
+    uint32_t hidden = 0U;
+    for (uint32_t i = 0; i < 25U; i++)
+    {
+        hidden |= m[i] << i;
+    }
+
+    return hidden;
+}
+
+void test_occlusion_mask_matches_boolean_cascade(void)
+{
+    // tiles that can hide other tiles
+    const uint32_t blockers[] = {
+        5U, 6U, 7U, 8U, 9U, 11U, 12U, 13U, 15U, 16U, 17U, 18U, 19U, 21U, 23U};
+    const uint32_t n_blockers = sizeof(blockers) / sizeof(blockers[0]);
+
+    for (uint32_t combination = 0; combination < (1U << n_blockers);
+         combination++)
+    {
+        uint32_t blocked = 0U;
+        for (uint32_t i = 0; i < n_blockers; i++)
+        {
+            blocked |= ((combination >> i) & 1U) << blockers[i];
+        }
+
+        // tiles that cannot hide others must not change the result
+        const uint32_t noise = (combination * 2654435761U)
+            & ((1U << 0) | (1U << 1) | (1U << 2) | (1U << 3) | (1U << 4)
+               | (1U << 10) | (1U << 14) | (1U << 20) | (1U << 22)
+               | (1U << 24));
+
+        TEST_ASSERT_EQUAL_HEX32(reference_occlusion_mask(blocked | noise),
+                                occlusion_mask(blocked | noise));
+    }
+}
+
+[[nodiscard]] static uint64_t *create_scratch(const uint32_t features)
+{
+    const size_t n_words = scratch_size(g_world_state, features);
+    uint64_t *scratch = (uint64_t *)calloc(n_words, sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(scratch);
+
+    init_scratch(g_world_state, scratch, features);
+    return scratch;
+}
+
+void test_init_scratch_builds_bitboard(void)
+{
+    g_map.tiles[9] = TILE_WALL;
+    g_map.tiles[10] = TILE_CLOSED_DOOR;
+    g_map.tiles[11] = TILE_OPEN_DOOR;
+
+    uint64_t *scratch = create_scratch(SCRATCH_BITBOARD);
+    TEST_ASSERT_EQUAL_UINT64(SCRATCH_VERSION, scratch[0]);
+    TEST_ASSERT_EQUAL_UINT64(SCRATCH_BITBOARD, scratch[1]);
+
+    attach_scratch(&g_world, scratch);
+    TEST_ASSERT_NOT_NULL(g_world.map.blocked);
+
+    for (uint32_t pos = 0; pos < g_map.n_rows * g_map.n_cols; pos++)
+    {
+        const uint32_t row = (pos / g_map.n_cols) + BITBOARD_HALO;
+        const uint32_t col = (pos % g_map.n_cols) + BITBOARD_HALO;
+        const uint64_t word =
+            *bitboard_word(&g_world.map, g_world.map.blocked, row, col);
+
+        TEST_ASSERT_EQUAL_UINT64(is_tile_blocked(g_map.tiles[pos]),
+                                 (word >> (col % BITS_PER_WORD)) & 1U);
+    }
+
+    free(scratch);
+}
+
+void test_tick_with_scratch_keeps_bitboard_in_sync(void)
+{
+    g_map.tiles[15] = TILE_OPEN_DOOR;
+    move_agent0(8);
+    move_agent1(23);
+    g_agents.orientations[0] = ORIENTATION_DOWN;
+
+    uint64_t *scratch = create_scratch(SCRATCH_BITBOARD);
+    const size_t n_words = scratch_size(g_world_state, SCRATCH_BITBOARD);
+
+    const uint32_t actions[][2] = {
+        {ACTION_CLOSE_DOOR, ACTION_MOVE_UP},
+        {ACTION_OPEN_DOOR, ACTION_MOVE_RIGHT},
+        {ACTION_TURN_270, ACTION_MOVE_DOWN},
+        {ACTION_MOVE_DOWN, ACTION_MOVE_LEFT},
+    };
+
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    uint32_t expected_states[2U * AGENT_STATE_SIZE] = {};
+    for (uint32_t i = 0; i < sizeof(actions) / sizeof(actions[0]); i++)
+    {
+        tick_with_scratch(g_world_state, scratch, states, actions[i], i);
+
+        uint64_t *expected = create_scratch(SCRATCH_BITBOARD);
+        TEST_ASSERT_EQUAL_UINT64_ARRAY(expected, scratch, n_words);
+        free(expected);
+
+        // observations taken from the bitboard match the ones without it
+        struct World world = load_world(g_world_state, 0U);
+        for (uint32_t j = 0; j < 2U; j++)
+        {
+            update_agent_state(
+                &world, expected_states + (j * AGENT_STATE_SIZE), j);
+        }
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            expected_states, states, 2U * AGENT_STATE_SIZE);
+    }
+
+    ASSERT_AGENT_POSITION(0, 15U);
+    ASSERT_AGENT_POSITION(1, 23U);
+    ASSERT_TILE(15, TILE_OPEN_DOOR_OCCUPIED);
+
+    free(scratch);
+}
+
+[[nodiscard]] static uint32_t *create_padded_world(void)
+{
+    const size_t n_words = padded_world_state_size(g_world_state);
+    uint32_t *padded_state = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(padded_state);
+
+    pad_world_state(g_world_state, padded_state);
+    return padded_state;
+}
+
+void test_load_world_with_padded_layout(void)
+{
+    g_map.tiles[41] = TILE_WALL;
+
+    uint32_t *padded_state = create_padded_world();
+    const struct World world = load_world(padded_state, 42U);
+
+    const uint32_t stride = 7U + (2U * MAP_HALO);
+    TEST_ASSERT_EQUAL_UINT32(2U, world.agents.n_agents);
+    TEST_ASSERT_EQUAL_UINT32(6U, world.map.n_rows);
+    TEST_ASSERT_EQUAL_UINT32(7U, world.map.n_cols);
+    TEST_ASSERT_EQUAL_UINT32(stride, world.map.stride);
+    TEST_ASSERT_EQUAL_UINT32(MAP_HALO, world.map.padding);
+
+    const uint32_t origin = (MAP_HALO * stride) + MAP_HALO;
+    TEST_ASSERT_EQUAL_UINT32(origin, world.agents.positions[0]);
+    TEST_ASSERT_EQUAL_UINT32(origin + 1U, world.agents.positions[1]);
+
+    TEST_ASSERT_EQUAL_UINT8(TILE_VOID, world.map.tiles[origin - 1U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_VOID, world.map.tiles[origin - stride]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR_OCCUPIED, world.map.tiles[origin]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_WALL,
+                            world.map.tiles[origin + (5U * stride) + 6U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_VOID,
+                            world.map.tiles[origin + (5U * stride) + 7U]);
+
+    TEST_ASSERT_EQUAL_size_t(padded_world_state_size(g_world_state),
+                             world_state_words(padded_state));
+
+    free(padded_state);
+}
+
+void test_ahead_in_padded_map_does_not_check_bounds(void)
+{
+    uint32_t *padded_state = create_padded_world();
+    const struct World world = load_world(padded_state, 42U);
+
+    const uint32_t stride = world.map.stride;
+    const uint32_t pos = world.agents.positions[0];
+
+    struct Pose pose = {.position = pos, .heading = ORIENTATION_UP};
+    TEST_ASSERT_EQUAL_UINT32(pos - stride, ahead(world.map, pose));
+
+    pose.heading = ORIENTATION_RIGHT;
+    TEST_ASSERT_EQUAL_UINT32(pos + 1U, ahead(world.map, pose));
+
+    pose.heading = ORIENTATION_DOWN;
+    TEST_ASSERT_EQUAL_UINT32(pos + stride, ahead(world.map, pose));
+
+    pose.heading = ORIENTATION_LEFT;
+    TEST_ASSERT_EQUAL_UINT32(pos - 1U, ahead(world.map, pose));
+
+    free(padded_state);
+}
+
+void test_tick_on_padded_world_matches_legacy_world(void)
+{
+    g_map.tiles[8] = TILE_CLOSED_DOOR;
+    g_map.tiles[13] = TILE_WALL;
+    move_agent1(6);
+    g_agents.orientations[0] = ORIENTATION_DOWN;
+
+    uint32_t *padded_state = create_padded_world();
+    const size_t n_words = padded_world_state_size(g_world_state);
+
+    uint32_t *scratch_world = create_padded_world();
+    const size_t n_scratch = scratch_size(scratch_world, SCRATCH_BITBOARD);
+    uint64_t *scratch = (uint64_t *)calloc(n_scratch, sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(scratch);
+    init_scratch(scratch_world, scratch, SCRATCH_BITBOARD);
+
+    const uint32_t actions[][2] = {
+        {ACTION_MOVE_LEFT, ACTION_MOVE_RIGHT},
+        {ACTION_MOVE_UP, ACTION_MOVE_UP},
+        {ACTION_TURN_90, ACTION_TURN_270},
+        {ACTION_MOVE_DOWN, ACTION_MOVE_LEFT},
+        {ACTION_TURN_180, ACTION_OPEN_DOOR},
+        {ACTION_MOVE_RIGHT, ACTION_MOVE_LEFT},
+        {ACTION_MOVE_DOWN, ACTION_CLOSE_DOOR},
+    };
+
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    uint32_t padded_states[2U * AGENT_STATE_SIZE] = {};
+    uint32_t scratch_states[2U * AGENT_STATE_SIZE] = {};
+    for (uint32_t i = 0; i < sizeof(actions) / sizeof(actions[0]); i++)
+    {
+        tick(g_world_state, states, actions[i], i);
+        tick(padded_state, padded_states, actions[i], i);
+        tick_with_scratch(
+            scratch_world, scratch, scratch_states, actions[i], i);
+
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            states, padded_states, 2U * AGENT_STATE_SIZE);
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            states, scratch_states, 2U * AGENT_STATE_SIZE);
+    }
+
+    uint32_t *expected = create_padded_world();
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, padded_state, n_words);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, scratch_world, n_words);
+
+    free(expected);
+    free(scratch);
+    free(scratch_world);
+    free(padded_state);
+}
+
+[[nodiscard]] static uint32_t *create_crowded_world(const uint32_t n_rows,
+                                                   const uint32_t n_cols)
+{
+    // one agent on every other tile and walls in between
+    const uint32_t n_tiles = n_rows * n_cols;
+    const uint32_t n_agents = n_tiles / 2U;
+    const size_t n_words = 3U + (2U * (size_t)n_agents)
+        + ((n_tiles + sizeof(uint32_t) - 1U) / sizeof(uint32_t));
+
+    uint32_t *world = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(world);
+
+    world[0] = n_agents;
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        world[1U + i] = 2U * i;
+        world[1U + n_agents + i] = i % 4U;
+    }
+    world[1U + (2U * n_agents)] = n_rows;
+    world[2U + (2U * n_agents)] = n_cols;
+
+    enum Tile *tiles = (enum Tile *)(world + 3U + (2U * n_agents));
+    for (uint32_t i = 0; i < n_tiles; i++)
+    {
+        tiles[i] = (i % 2U == 0) ? TILE_FLOOR_OCCUPIED
+            : (i % 7U == 0)      ? TILE_WALL
+                                 : TILE_FLOOR;
+    }
+
+    return world;
+}
+
+/* Compares observations with the scalar FoV and occlusion, which checks the
+ * bitboard path of `update_agent_state()` and its SIMD path in
+ * `build/unit_tests_simd`.
+ */
+void test_update_agent_state_matches_scalar_fov(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 13U,
+        n_cols = 11U,
+    };
+
+    const enum Tile tile_kinds[] = {
+        TILE_FLOOR, TILE_WALL, TILE_OPEN_DOOR, TILE_CLOSED_DOOR};
+
+    uint32_t *world_state = create_crowded_world(n_rows, n_cols);
+    const uint32_t n_agents = world_state[0];
+    enum Tile *tiles = (enum Tile *)(world_state + 3U + (2U * n_agents));
+    for (uint32_t i = 0; i < n_rows * n_cols; i++)
+    {
+        const uint32_t hash = i * 2654435761U;
+        if (tiles[i] != TILE_FLOOR_OCCUPIED)
+        {
+            tiles[i] = tile_kinds[hash >> 30U];
+        }
+        else if (hash >> 31U != 0U)
+        {
+            tiles[i] = TILE_OPEN_DOOR_OCCUPIED;
+        }
+    }
+
+    const size_t n_padded = padded_world_state_size(world_state);
+    uint32_t *padded_state = (uint32_t *)calloc(n_padded, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(padded_state);
+
+    for (uint32_t heading = 0; heading < 4U; heading++)
+    {
+        for (uint32_t i = 0; i < n_agents; i++)
+        {
+            world_state[1U + n_agents + i] = (i + heading) % 4U;
+        }
+        pad_world_state(world_state, padded_state);
+
+        uint32_t *states[] = {world_state, padded_state};
+        for (uint32_t s = 0; s < 2U; s++)
+        {
+            const size_t n_scratch = scratch_size(states[s], SCRATCH_BITBOARD);
+            uint64_t *scratch = (uint64_t *)calloc(n_scratch, sizeof(uint64_t));
+            TEST_ASSERT_NOT_NULL(scratch);
+            init_scratch(states[s], scratch, SCRATCH_BITBOARD);
+
+            const struct World world = load_world(states[s], 0U);
+            struct World bitboard_world = load_world(states[s], 0U);
+            attach_scratch(&bitboard_world, scratch);
+            for (uint32_t i = 0; i < n_agents; i++)
+            {
+                uint32_t agent_state[AGENT_STATE_SIZE] = {};
+                update_agent_state(&world, agent_state, i);
+
+                uint32_t bitboard_state[AGENT_STATE_SIZE] = {};
+                update_agent_state(&bitboard_world, bitboard_state, i);
+
+                uint32_t expected[AGENT_STATE_SIZE] = {
+                    AGENT_STATE_VERSION, FOV_SIZE, FOV_SIZE, FOV_SELF_IDX};
+                fill_agent_fov(&world, i, (enum Tile *)(expected + 4U));
+                apply_occlusion((enum Tile *)(expected + 4U));
+
+                TEST_ASSERT_EQUAL_UINT32_ARRAY(
+                    expected, agent_state, AGENT_STATE_SIZE);
+                TEST_ASSERT_EQUAL_UINT32_ARRAY(
+                    expected, bitboard_state, AGENT_STATE_SIZE);
+            }
+
+            free(scratch);
+        }
+    }
+
+    free(padded_state);
+    free(world_state);
+}
+
+void test_tick_with_threads_matches_serial_tick(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+        n_threads = 4U,
+    };
+
+    uint32_t *world = create_crowded_world(n_rows, n_cols);
+    uint32_t *expected_world = create_crowded_world(n_rows, n_cols);
+    const uint32_t n_agents = world[0];
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(MIN_AGENTS_PER_THREAD * n_threads,
+                                        n_agents);
+
+    const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+    uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *expected_states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(states);
+    TEST_ASSERT_NOT_NULL(expected_states);
+    TEST_ASSERT_NOT_NULL(actions);
+
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        actions[i] = (i * 5U) % (ACTION_CLOSE_DOOR + 1U);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1U, set_thread_count(1U));
+    tick(expected_world, expected_states, actions, 7U);
+
+#ifdef ENGINE_THREADS
+    TEST_ASSERT_EQUAL_UINT32(n_threads, set_thread_count(n_threads));
+#endif
+    tick(world, states, actions, 7U);
+    set_thread_count(1U);
+
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected_world, world, world_state_words(world));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_states, states, n_states);
+
+    free(actions);
+    free(expected_states);
+    free(states);
+    free(expected_world);
+    free(world);
+}
+
+[[nodiscard]] static uint64_t *create_claim_table(uint32_t *world_state)
+{
+    const uint32_t features = SCRATCH_BITBOARD | SCRATCH_CLAIM_TABLE;
+    const size_t n_words = scratch_size(world_state, features);
+    uint64_t *scratch = (uint64_t *)calloc(n_words, sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(scratch);
+
+    init_scratch(world_state, scratch, features);
+    return scratch;
+}
+
+static void assert_claims_released(uint32_t *world_state, uint64_t *scratch)
+{
+    struct World world = load_world(world_state, 0U);
+    attach_scratch(&world, scratch);
+    TEST_ASSERT_NOT_NULL(world.claims);
+
+    for (size_t i = 0; i < map_tiles(&world.map); i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(NO_CLAIM, world.claims[i]);
+    }
+}
+
+void test_tick_with_claim_table_resolves_conflicts_in_action_order(void)
+{
+    // both agents move into tile 1
+    move_agent1(2);
+    const uint32_t actions[] = {ACTION_MOVE_RIGHT, ACTION_MOVE_LEFT};
+    const size_t n_bytes =
+        (7U * sizeof(uint32_t)) + (size_t)(g_map.n_rows * g_map.n_cols);
+
+    for (uint32_t seed = 1; seed <= 8U; seed++)
+    {
+        uint32_t *world_state = create_world();
+        uint32_t *expected = create_world();
+        TEST_ASSERT_NOT_NULL(world_state);
+        TEST_ASSERT_NOT_NULL(expected);
+        memcpy(world_state, g_world_state, n_bytes);
+        memcpy(expected, g_world_state, n_bytes);
+
+        uint64_t *scratch = create_claim_table(world_state);
+
+        uint32_t states[2U * AGENT_STATE_SIZE] = {};
+        uint32_t expected_states[2U * AGENT_STATE_SIZE] = {};
+        tick_with_scratch(world_state, scratch, states, actions, seed);
+        tick(expected, expected_states, actions, seed);
+
+        // the agent acting first wins in both modes
+        TEST_ASSERT_TRUE((world_state[1] == 1U) != (world_state[2] == 1U));
+        TEST_ASSERT_EQUAL_MEMORY(expected, world_state, n_bytes);
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            expected_states, states, 2U * AGENT_STATE_SIZE);
+        assert_claims_released(world_state, scratch);
+
+        free(scratch);
+        free(expected);
+        free(world_state);
+    }
+}
+
+void test_tick_with_claim_table_blocks_occupied_targets(void)
+{
+    const uint32_t actions[][2] = {
+        {ACTION_MOVE_RIGHT, ACTION_MOVE_RIGHT}, // agent 0 follows agent 1
+        {ACTION_MOVE_RIGHT, ACTION_MOVE_LEFT},  // agents swap
+    };
+    const uint32_t expected_positions[][2] = {{0U, 2U}, {0U, 1U}};
+
+    for (uint32_t i = 0; i < 2U; i++)
+    {
+        for (uint32_t seed = 1; seed <= 8U; seed++)
+        {
+            uint32_t *world_state = create_world();
+            TEST_ASSERT_NOT_NULL(world_state);
+            uint64_t *scratch = create_claim_table(world_state);
+
+            uint32_t states[2U * AGENT_STATE_SIZE] = {};
+            tick_with_scratch(world_state, scratch, states, actions[i], seed);
+
+            TEST_ASSERT_EQUAL_UINT32(expected_positions[i][0], world_state[1]);
+            TEST_ASSERT_EQUAL_UINT32(expected_positions[i][1], world_state[2]);
+            assert_claims_released(world_state, scratch);
+
+            free(scratch);
+            free(world_state);
+        }
+    }
+}
+
+void test_tick_with_claim_table_does_not_depend_on_thread_count(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+        n_threads = 4U,
+    };
+
+    uint32_t *world = create_crowded_world(n_rows, n_cols);
+    uint32_t *expected_world = create_crowded_world(n_rows, n_cols);
+    uint64_t *scratch = create_claim_table(world);
+    uint64_t *expected_scratch = create_claim_table(expected_world);
+    const uint32_t n_agents = world[0];
+
+    const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+    uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *expected_states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(states);
+    TEST_ASSERT_NOT_NULL(expected_states);
+    TEST_ASSERT_NOT_NULL(actions);
+
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        actions[i] = (i * 7U) % (ACTION_CLOSE_DOOR + 1U);
+    }
+
+    for (uint32_t seed = 1; seed <= 4U; seed++)
+    {
+        set_thread_count(1U);
+        tick_with_scratch(
+            expected_world, expected_scratch, expected_states, actions, seed);
+
+        set_thread_count(n_threads);
+        tick_with_scratch(world, scratch, states, actions, seed);
+        set_thread_count(1U);
+
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            expected_world, world, world_state_words(world));
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_states, states, n_states);
+        assert_claims_released(world, scratch);
+    }
+
+    free(actions);
+    free(expected_states);
+    free(states);
+    free(expected_scratch);
+    free(scratch);
+    free(expected_world);
+    free(world);
+}
+
+void test_random_word_has_independent_streams(void)
+{
+    struct World world = load_world(g_world_state, 1U);
+    const uint32_t word = random_word(&world, STREAM_ACTION_ORDER, 0U);
+
+    // words neither depend on the order of draws nor repeat across streams
+    TEST_ASSERT_NOT_EQUAL(word, random_word(&world, STREAM_ACTION_ORDER, 1U));
+    TEST_ASSERT_EQUAL_UINT32(word,
+                             random_word(&world, STREAM_ACTION_ORDER, 0U));
+
+    world.rng_key = rng_key(1U, 1U);
+    TEST_ASSERT_NOT_EQUAL(word, random_word(&world, STREAM_ACTION_ORDER, 0U));
+
+    world.rng_key = rng_key(2U, 0U);
+    TEST_ASSERT_NOT_EQUAL(word, random_word(&world, STREAM_ACTION_ORDER, 0U));
+}
+
+void test_action_order_is_uniform_across_seeds(void)
+{
+    enum : uint32_t
+    {
+        n_agents = 4U,
+        n_seeds = 4096U,
+    };
+
+    uint32_t n_first[n_agents] = {};
+    uint32_t n_forwards = 0U;
+
+    struct World world = load_world(g_world_state, 0U);
+    world.agents.n_agents = n_agents;
+    for (uint32_t seed = 0; seed < n_seeds; seed++)
+    {
+        world.rng_key = rng_key(seed, 0U);
+        const struct ActionOrder order = action_order(&world);
+        n_first[order.first]++;
+        n_forwards += (order.increment == 1U) ? 1U : 0U;
+    }
+
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        TEST_ASSERT_UINT32_WITHIN(
+            n_seeds / 16U, n_seeds / n_agents, n_first[i]);
+    }
+    TEST_ASSERT_UINT32_WITHIN(n_seeds / 16U, n_seeds / 2U, n_forwards);
+}
+
+void test_restore_world_undoes_ticks(void)
+{
+    const size_t n_words = world_state_words(g_world_state);
+    const size_t n_bytes = world_state_bytes(g_world_state);
+    uint32_t *expected = create_world();
+    uint32_t *snapshot = (uint32_t *)calloc(
+        snapshot_size(g_world_state), sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(snapshot);
+    TEST_ASSERT_EQUAL_size_t(n_words + 2U, snapshot_size(g_world_state));
+
+    g_map.tiles[9] = TILE_CLOSED_DOOR;
+    memcpy(expected, g_world_state, n_bytes);
+    snapshot_world(g_world_state, snapshot);
+    TEST_ASSERT_EQUAL_UINT32(SNAPSHOT_VERSION, snapshot[0]);
+    TEST_ASSERT_EQUAL_UINT32(n_bytes, snapshot[1]);
+
+    // agent 1 opens the door after walking up to it
+    const uint32_t actions[][2] = {
+        {ACTION_NONE, ACTION_MOVE_DOWN},
+        {ACTION_TURN_90, ACTION_TURN_90},
+        {ACTION_MOVE_DOWN, ACTION_OPEN_DOOR},
+    };
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    for (uint32_t i = 0; i < 3U; i++)
+    {
+        tick(g_world_state, states, actions[i], i);
+    }
+    ASSERT_TILE(9, TILE_OPEN_DOOR);
+
+    TEST_ASSERT_TRUE(restore_world(g_world_state, NULL, snapshot));
+    TEST_ASSERT_EQUAL_MEMORY(expected, g_world_state, n_bytes);
+
+    free(snapshot);
+    free(expected);
+}
+
+void test_restore_world_reinitializes_scratch(void)
+{
+    uint32_t *snapshot = (uint32_t *)calloc(
+        snapshot_size(g_world_state), sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(snapshot);
+    snapshot_world(g_world_state, snapshot);
+
+    uint64_t *scratch = create_claim_table(g_world_state);
+    const size_t n_words = SCRATCH_HEADER_SIZE + bitboard_words(&g_map);
+    uint64_t *expected = (uint64_t *)calloc(n_words, sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(expected);
+    memcpy(expected, scratch, n_words * sizeof(uint64_t));
+
+    const uint32_t actions[] = {ACTION_MOVE_DOWN, ACTION_MOVE_DOWN};
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    tick_with_scratch(g_world_state, scratch, states, actions, 1U);
+    TEST_ASSERT_NOT_EQUAL(
+        0, memcmp(expected, scratch, n_words * sizeof(uint64_t)));
+
+    TEST_ASSERT_TRUE(restore_world(g_world_state, scratch, snapshot));
+    TEST_ASSERT_EQUAL_UINT64_ARRAY(expected, scratch, n_words);
+    assert_claims_released(g_world_state, scratch);
+
+    free(expected);
+    free(scratch);
+    free(snapshot);
+}
+
+void test_restore_world_rejects_snapshot_of_other_version(void)
+{
+    const size_t n_bytes = world_state_bytes(g_world_state);
+    uint32_t *expected = create_world();
+    uint32_t *snapshot = (uint32_t *)calloc(
+        snapshot_size(g_world_state), sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(snapshot);
+
+    snapshot_world(g_world_state, snapshot);
+    g_map.tiles[9] = TILE_CLOSED_DOOR;
+    memcpy(expected, g_world_state, n_bytes);
+
+    snapshot[0] = SNAPSHOT_VERSION + 1U;
+    TEST_ASSERT_FALSE(restore_world(g_world_state, NULL, snapshot));
+    TEST_ASSERT_EQUAL_MEMORY(expected, g_world_state, n_bytes);
+
+    free(snapshot);
+    free(expected);
+}
+
+void test_restore_world_rejects_snapshot_of_other_size(void)
+{
+    // the same world with one more row of tiles
+    const size_t n_bytes = world_state_bytes(g_world_state);
+    const size_t n_taller_bytes = n_bytes + 7U;
+    uint32_t *taller = (uint32_t *)calloc(
+        (n_taller_bytes + sizeof(uint32_t) - 1U) / sizeof(uint32_t),
+        sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(taller);
+    memcpy(taller, g_world_state, n_bytes);
+    taller[5] = 7U;
+    TEST_ASSERT_EQUAL_size_t(n_taller_bytes, world_state_bytes(taller));
+
+    uint32_t *expected = create_world();
+    uint32_t *snapshot =
+        (uint32_t *)calloc(snapshot_size(taller), sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(snapshot);
+
+    snapshot_world(taller, snapshot);
+    TEST_ASSERT_FALSE(restore_world(g_world_state, NULL, snapshot));
+    TEST_ASSERT_EQUAL_MEMORY(expected, g_world_state, n_bytes);
+
+    free(snapshot);
+    free(expected);
+    free(taller);
+}
+
+[[nodiscard]] static uint64_t *create_fork(uint32_t *world_state,
+                                          const uint32_t n_chunks)
+{
+    uint64_t *fork =
+        (uint64_t *)calloc(fork_size(world_state, n_chunks), sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(fork);
+
+    fork_world(world_state, fork, n_chunks);
+    return fork;
+}
+
+[[nodiscard]] static uint64_t *create_fork_of_fork(uint32_t *world_state,
+                                                  uint64_t *parent,
+                                                  const uint32_t n_chunks)
+{
+    uint64_t *fork =
+        (uint64_t *)calloc(fork_size(world_state, n_chunks), sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(fork);
+
+    fork_fork(parent, fork, n_chunks);
+    return fork;
+}
+
+static void assert_fork_matches_world(uint64_t *fork, uint32_t *world_state)
+{
+    struct ChunkTable table;
+    const struct World world = load_fork(fork, &table, 0U);
+    const struct World expected = load_world(world_state, 0U);
+    const uint32_t n_agents = expected.agents.n_agents;
+
+    TEST_ASSERT_EQUAL_UINT32(n_agents, world.agents.n_agents);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected.agents.positions, world.agents.positions, n_agents);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected.agents.orientations, world.agents.orientations, n_agents);
+
+    for (uint32_t i = 0; i < map_tiles(&expected.map); i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(expected.map.tiles[i], tile_at(&world.map, i));
+    }
+}
+
+void test_tick_fork_copies_written_chunks_only(void)
+{
+    uint32_t *expected = create_world();
+    TEST_ASSERT_NOT_NULL(expected);
+    memcpy(expected, g_world_state, world_state_bytes(g_world_state));
+
+    uint64_t *fork = create_fork(g_world_state, 4U);
+    assert_fork_matches_world(fork, g_world_state);
+
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    uint32_t expected_states[2U * AGENT_STATE_SIZE] = {};
+
+    // turning does not write to the map
+    const uint32_t turns[] = {ACTION_TURN_90, ACTION_TURN_180};
+    TEST_ASSERT_EQUAL_UINT32(4U, tick_fork(fork, states, turns, 1U));
+    tick(expected, expected_states, turns, 1U);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected_states, states, 2U * AGENT_STATE_SIZE);
+
+    const uint32_t moves[] = {ACTION_MOVE_DOWN, ACTION_MOVE_DOWN};
+    TEST_ASSERT_EQUAL_UINT32(3U, tick_fork(fork, states, moves, 2U));
+    tick(expected, expected_states, moves, 2U);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected_states, states, 2U * AGENT_STATE_SIZE);
+    assert_fork_matches_world(fork, expected);
+
+    // the world is unchanged
+    ASSERT_AGENT_POSITION(0, 0U);
+    ASSERT_AGENT_POSITION(1, 1U);
+    ASSERT_TILE(0, TILE_FLOOR_OCCUPIED);
+    ASSERT_TILE(7, TILE_FLOOR);
+
+    free(fork);
+    free(expected);
+}
+
+void test_tick_fork_without_free_chunks_does_not_tick(void)
+{
+    uint64_t *fork = create_fork(g_world_state, 0U);
+
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    const uint32_t moves[] = {ACTION_MOVE_DOWN, ACTION_MOVE_DOWN};
+    TEST_ASSERT_EQUAL_UINT32(FORK_FULL, tick_fork(fork, states, moves, 1U));
+
+    // the moves may write to the only chunk of the map, which cannot be owned
+    assert_fork_matches_world(fork, g_world_state);
+    TEST_ASSERT_EQUAL_UINT64(0U, fork[2]);
+    TEST_ASSERT_EACH_EQUAL_UINT32(0U, states, 2U * AGENT_STATE_SIZE);
+
+    free(fork);
+}
+
+void test_tick_fork_of_fork_leaves_parent_unchanged(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+    };
+
+    uint32_t *world = create_crowded_world(n_rows, n_cols);
+    uint32_t *expected_world = create_crowded_world(n_rows, n_cols);
+    uint32_t *expected_parent = create_crowded_world(n_rows, n_cols);
+    const uint32_t n_agents = world[0];
+    const uint32_t n_chunks = (n_rows * n_cols) / CHUNK_TILES;
+
+    const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+    uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *expected_states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(states);
+    TEST_ASSERT_NOT_NULL(expected_states);
+    TEST_ASSERT_NOT_NULL(actions);
+
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        actions[i] = (i * 5U) % (ACTION_CLOSE_DOOR + 1U);
+    }
+
+    uint64_t *parent = create_fork(world, n_chunks);
+    tick_fork(parent, states, actions, 1U);
+    tick(expected_parent, expected_states, actions, 1U);
+    tick(expected_world, expected_states, actions, 1U);
+
+    uint64_t *fork = create_fork_of_fork(world, parent, n_chunks);
+    tick_fork(fork, states, actions, 2U);
+    tick(expected_world, expected_states, actions, 2U);
+
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_states, states, n_states);
+    assert_fork_matches_world(fork, expected_world);
+    assert_fork_matches_world(parent, expected_parent);
+
+    free(fork);
+    free(parent);
+    free(actions);
+    free(expected_states);
+    free(states);
+    free(expected_parent);
+    free(expected_world);
+    free(world);
+}
+
+void test_untick_reverts_ticks_in_reverse_order(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+        n_ticks = 3U,
+    };
+
+    uint32_t *world = create_crowded_world(n_rows, n_cols);
+    const uint32_t n_agents = world[0];
+    const size_t n_words = world_state_words(world);
+    uint32_t *expected =
+        (uint32_t *)calloc(n_ticks * n_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(expected);
+
+    uint64_t *scratch = create_claim_table(world);
+    const struct World loaded = load_world(world, 0U);
+    const size_t n_scratch =
+        SCRATCH_HEADER_SIZE + bitboard_words(&loaded.map);
+    uint64_t *expected_scratch =
+        (uint64_t *)calloc(n_ticks * n_scratch, sizeof(uint64_t));
+    uint64_t *undo_log =
+        (uint64_t *)calloc(undo_log_size(world, n_ticks), sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(expected_scratch);
+    TEST_ASSERT_NOT_NULL(undo_log);
+    init_undo_log(world, undo_log, n_ticks);
+
+    const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+    uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(states);
+    TEST_ASSERT_NOT_NULL(actions);
+
+    for (uint32_t t = 0; t < n_ticks; t++)
+    {
+        memcpy(expected + (t * n_words), world, n_words * sizeof(uint32_t));
+        memcpy(expected_scratch + (t * n_scratch),
+               scratch,
+               n_scratch * sizeof(uint64_t));
+
+        for (uint32_t i = 0; i < n_agents; i++)
+        {
+            actions[i] = ((i * 5U) + t) % (ACTION_CLOSE_DOOR + 1U);
+        }
+        const uint32_t n_left = tick_with_undo_log(
+            world, scratch, undo_log, states, actions, t + 1U);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(n_ticks - 1U - t, n_left);
+    }
+
+    for (uint32_t t = n_ticks; t-- > 0;)
+    {
+        TEST_ASSERT_EQUAL_UINT32(t, untick(world, scratch, undo_log));
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            expected + (t * n_words), world, n_words);
+        TEST_ASSERT_EQUAL_UINT64_ARRAY(
+            expected_scratch + (t * n_scratch), scratch, n_scratch);
+    }
+
+    // an empty log is left as is
+    TEST_ASSERT_EQUAL_UINT32(0U, untick(world, NULL, undo_log));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, world, n_words);
+
+    free(actions);
+    free(states);
+    free(undo_log);
+    free(expected_scratch);
+    free(scratch);
+    free(expected);
+    free(world);
+}
+
+void test_untick_without_scratch_reverts_doors(void)
+{
+    g_agents.orientations[1] = ORIENTATION_RIGHT;
+    g_map.tiles[2] = TILE_CLOSED_DOOR;
+
+    const size_t n_bytes = world_state_bytes(g_world_state);
+    uint32_t *expected = create_world();
+    TEST_ASSERT_NOT_NULL(expected);
+    memcpy(expected, g_world_state, n_bytes);
+
+    uint64_t *undo_log = (uint64_t *)calloc(
+        undo_log_size(g_world_state, 2U), sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(undo_log);
+    init_undo_log(g_world_state, undo_log, 2U);
+
+    // agent 1 opens the door and walks into it
+    const uint32_t actions[][2] = {
+        {ACTION_TURN_180, ACTION_OPEN_DOOR},
+        {ACTION_MOVE_DOWN, ACTION_MOVE_RIGHT},
+    };
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    for (uint32_t i = 0; i < 2U; i++)
+    {
+        const uint32_t n_left = tick_with_undo_log(
+            g_world_state, NULL, undo_log, states, actions[i], i);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1U - i, n_left);
+    }
+    ASSERT_AGENT_POSITION(0, 7U);
+    ASSERT_AGENT_POSITION(1, 2U);
+    ASSERT_TILE(2, TILE_OPEN_DOOR_OCCUPIED);
+
+    TEST_ASSERT_EQUAL_UINT32(1U, untick(g_world_state, NULL, undo_log));
+    ASSERT_TILE(2, TILE_OPEN_DOOR);
+    TEST_ASSERT_EQUAL_UINT32(0U, untick(g_world_state, NULL, undo_log));
+    TEST_ASSERT_EQUAL_MEMORY(expected, g_world_state, n_bytes);
+    TEST_ASSERT_EQUAL_UINT64(0U, undo_log[2]);
+
+    free(undo_log);
+    free(expected);
+}
+
+void test_tick_with_observation_cache_matches_tick(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+        n_ticks = 8U,
+    };
+
+    const uint32_t features[] = {
+        SCRATCH_OBSERVATION_CACHE,
+        SCRATCH_OBSERVATION_CACHE | SCRATCH_BITBOARD,
+        SCRATCH_OBSERVATION_CACHE | SCRATCH_CLAIM_TABLE,
+    };
+
+    for (uint32_t f = 0; f < 3U; f++)
+    {
+        uint32_t *world = create_crowded_world(n_rows, n_cols);
+        uint32_t *expected_world = create_crowded_world(n_rows, n_cols);
+        const uint32_t n_agents = world[0];
+
+        const size_t n_words = scratch_size(world, features[f]);
+        uint64_t *scratch = (uint64_t *)calloc(n_words, sizeof(uint64_t));
+        uint64_t *expected_scratch =
+            (uint64_t *)calloc(n_words, sizeof(uint64_t));
+        TEST_ASSERT_NOT_NULL(scratch);
+        TEST_ASSERT_NOT_NULL(expected_scratch);
+        init_scratch(world, scratch, features[f]);
+        init_scratch(expected_world,
+                     expected_scratch,
+                     features[f] & ~(uint32_t)SCRATCH_OBSERVATION_CACHE);
+
+        const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+        uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+        uint32_t *expected_states =
+            (uint32_t *)calloc(n_states, sizeof(uint32_t));
+        uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+        TEST_ASSERT_NOT_NULL(states);
+        TEST_ASSERT_NOT_NULL(expected_states);
+        TEST_ASSERT_NOT_NULL(actions);
+
+        for (uint32_t t = 0; t < n_ticks; t++)
+        {
+            // most agents idle in every other tick
+            for (uint32_t i = 0; i < n_agents; i++)
+            {
+                actions[i] = (t % 2U == 0 || i % 16U == 0)
+                    ? ((i * 5U) + t) % (ACTION_CLOSE_DOOR + 1U)
+                    : ACTION_NONE;
+            }
+
+            tick_with_scratch(world, scratch, states, actions, t);
+            tick_with_scratch(
+                expected_world, expected_scratch, expected_states, actions, t);
+
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(
+                expected_world, world, world_state_words(world));
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_states, states, n_states);
+        }
+
+        free(actions);
+        free(expected_states);
+        free(states);
+        free(expected_scratch);
+        free(scratch);
+        free(expected_world);
+        free(world);
+    }
+}
+
+void test_tick_with_observation_cache_skips_unaffected_agents(void)
+{
+    // agent 1 is far away from agent 0
+    move_agent1(34);
+    uint64_t *scratch = create_scratch(SCRATCH_OBSERVATION_CACHE);
+
+    uint32_t states[2U * AGENT_STATE_SIZE] = {};
+    const uint32_t idle[] = {ACTION_NONE, ACTION_NONE};
+    tick_with_scratch(g_world_state, scratch, states, idle, 1U);
+    TEST_ASSERT_EQUAL_UINT32(AGENT_STATE_VERSION, states[0]);
+    TEST_ASSERT_EQUAL_UINT32(AGENT_STATE_VERSION, states[AGENT_STATE_SIZE]);
+
+    states[0] = 0U;
+    states[AGENT_STATE_SIZE] = 0U;
+    tick_with_scratch(g_world_state, scratch, states, idle, 2U);
+    TEST_ASSERT_EQUAL_UINT32(0U, states[0]);
+    TEST_ASSERT_EQUAL_UINT32(0U, states[AGENT_STATE_SIZE]);
+
+    // only the moving agent 0 is observed again
+    const uint32_t moves[] = {ACTION_MOVE_RIGHT, ACTION_NONE};
+    tick_with_scratch(g_world_state, scratch, states, moves, 3U);
+    TEST_ASSERT_EQUAL_UINT32(AGENT_STATE_VERSION, states[0]);
+    TEST_ASSERT_EQUAL_UINT32(0U, states[AGENT_STATE_SIZE]);
+
+    // agent 1 sees the door that is closed in front of it
+    g_map.tiles[27] = TILE_OPEN_DOOR;
+    init_scratch(g_world_state, scratch, SCRATCH_OBSERVATION_CACHE);
+    tick_with_scratch(g_world_state, scratch, states, idle, 4U);
+    states[0] = 0U;
+    states[AGENT_STATE_SIZE] = 0U;
+
+    const uint32_t close[] = {ACTION_NONE, ACTION_CLOSE_DOOR};
+    tick_with_scratch(g_world_state, scratch, states, close, 5U);
+    TEST_ASSERT_EQUAL_UINT32(0U, states[0]);
+    TEST_ASSERT_EQUAL_UINT32(AGENT_STATE_VERSION, states[AGENT_STATE_SIZE]);
+    ASSERT_TILE(27, TILE_CLOSED_DOOR);
+
+    free(scratch);
+}
+
+void test_visible_agents_respects_occlusion(void)
+{
+    move_agent0(35);
+    move_agent1(21);
+    uint64_t *scratch = create_scratch(SCRATCH_AGENT_GRID);
+
+    uint32_t agent_ids[(FOV_SIZE * FOV_SIZE) - 1U] = {};
+    TEST_ASSERT_EQUAL_UINT32(
+        1U, visible_agents(g_world_state, scratch, 0U, agent_ids));
+    TEST_ASSERT_EQUAL_UINT32(1U, agent_ids[0]);
+
+    // agent 1 faces away from agent 0
+    TEST_ASSERT_EQUAL_UINT32(
+        0U, visible_agents(g_world_state, scratch, 1U, agent_ids));
+
+    // a wall in between hides agent 1
+    g_map.tiles[28] = TILE_WALL;
+    init_scratch(g_world_state, scratch, SCRATCH_AGENT_GRID);
+    TEST_ASSERT_EQUAL_UINT32(
+        0U, visible_agents(g_world_state, scratch, 0U, agent_ids));
+
+    free(scratch);
+}
+
+void test_visible_agents_without_agent_grid_finds_none(void)
+{
+    move_agent0(35);
+    move_agent1(21);
+    uint64_t *scratch = create_scratch(SCRATCH_BITBOARD);
+
+    uint32_t agent_ids[(FOV_SIZE * FOV_SIZE) - 1U] = {};
+    TEST_ASSERT_EQUAL_UINT32(
+        0U, visible_agents(g_world_state, scratch, 0U, agent_ids));
+
+    free(scratch);
+}
+
+static void assert_agent_grid_in_sync(uint32_t *world_state, uint64_t *scratch)
+{
+    struct World world = load_world(world_state, 0U);
+    attach_scratch(&world, scratch);
+    TEST_ASSERT_NOT_NULL(world.agent_ids);
+
+    uint32_t n_agents = 0U;
+    for (uint32_t i = 0; i < map_tiles(&world.map); i++)
+    {
+        const uint32_t agent = world.agent_ids[i];
+        if (agent != NO_AGENT)
+        {
+            TEST_ASSERT_EQUAL_UINT32(i, world.agents.positions[agent]);
+            n_agents++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(world.agents.n_agents, n_agents);
+}
+
+void test_agent_grid_follows_moves(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+        n_ticks = 4U,
+    };
+
+    const uint32_t features[] = {
+        SCRATCH_AGENT_GRID,
+        SCRATCH_AGENT_GRID | SCRATCH_CLAIM_TABLE,
+    };
+
+    for (uint32_t f = 0; f < 2U; f++)
+    {
+        uint32_t *world = create_crowded_world(n_rows, n_cols);
+        const uint32_t n_agents = world[0];
+        const size_t n_words = scratch_size(world, features[f]);
+        uint64_t *scratch = (uint64_t *)calloc(n_words, sizeof(uint64_t));
+        uint64_t *undo_log =
+            (uint64_t *)calloc(undo_log_size(world, n_ticks), sizeof(uint64_t));
+        TEST_ASSERT_NOT_NULL(scratch);
+        TEST_ASSERT_NOT_NULL(undo_log);
+        init_scratch(world, scratch, features[f]);
+        init_undo_log(world, undo_log, n_ticks);
+
+        const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+        uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+        uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+        TEST_ASSERT_NOT_NULL(states);
+        TEST_ASSERT_NOT_NULL(actions);
+
+        for (uint32_t t = 0; t < n_ticks; t++)
+        {
+            for (uint32_t i = 0; i < n_agents; i++)
+            {
+                actions[i] = ACTION_MOVE_UP + ((i + t) % 4U);
+            }
+            (void)tick_with_undo_log(
+                world, scratch, undo_log, states, actions, t);
+            assert_agent_grid_in_sync(world, scratch);
+        }
+
+        while (untick(world, scratch, undo_log) != 0)
+        {
+            assert_agent_grid_in_sync(world, scratch);
+        }
+        assert_agent_grid_in_sync(world, scratch);
+
+        free(actions);
+        free(states);
+        free(undo_log);
+        free(scratch);
+        free(world);
+    }
+}
+
+void test_observe_shadowcast_reveals_open_map(void)
+{
+    enum : uint32_t
+    {
+        radius = 6U,
+        n_cols = (2U * radius) + 1U,
+    };
+
+    move_agent0(38);
+    move_agent1(6);
+
+    uint32_t state[256] = {};
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(256U / 2U, shadowcast_state_size(radius));
+    observe_shadowcast(g_world_state, radius, state);
+
+    TEST_ASSERT_EQUAL_UINT32(AGENT_STATE_VERSION, state[0]);
+    TEST_ASSERT_EQUAL_UINT32(radius + 1U, state[1]);
+    TEST_ASSERT_EQUAL_UINT32(n_cols, state[2]);
+    TEST_ASSERT_EQUAL_UINT32((radius * n_cols) + radius, state[3]);
+
+    // agent 0 looks up from row 5 and column 3 of the 6x7 map
+    const enum Tile *tiles = (const enum Tile *)(state + 4U);
+    for (uint32_t i = 0; i <= radius; i++)
+    {
+        for (uint32_t j = 0; j < n_cols; j++)
+        {
+            const uint32_t row = i - 1U;
+            const uint32_t col = j - 3U;
+            const enum Tile expected = (row < 6U && col < 7U)
+                ? g_map.tiles[(row * 7U) + col]
+                : TILE_HIDDEN;
+            TEST_ASSERT_EQUAL_UINT8(expected, tiles[(i * n_cols) + j]);
+        }
+    }
+
+    // agent 1 looks up from the top right corner
+    const enum Tile *tiles1 =
+        (const enum Tile *)(state + shadowcast_state_size(radius) + 4U);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR_OCCUPIED,
+                            tiles1[(radius * n_cols) + radius]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles1[(radius * n_cols) + 0U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN,
+                            tiles1[((radius - 1U) * n_cols) + radius]);
+}
+
+void test_observe_shadowcast_casts_shadows(void)
+{
+    enum : uint32_t
+    {
+        radius = 6U,
+        n_cols = (2U * radius) + 1U,
+    };
+
+    move_agent0(38);
+    move_agent1(6);
+    g_map.tiles[24] = TILE_WALL;
+
+    uint32_t state[256] = {};
+    observe_shadowcast(g_world_state, radius, state);
+
+    // the wall two tiles ahead hides the tiles behind it
+    const enum Tile *tiles = (const enum Tile *)(state + 4U);
+    const uint32_t self = (radius * n_cols) + radius;
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[self - n_cols]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_WALL, tiles[self - (2U * n_cols)]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, tiles[self - (3U * n_cols)]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, tiles[self - (5U * n_cols)]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[self - (3U * n_cols) - 3U]);
+
+    // facing right, the wall is two tiles to the left
+    g_agents.orientations[0] = ORIENTATION_RIGHT;
+    observe_shadowcast(g_world_state, radius, state);
+    TEST_ASSERT_EQUAL_UINT8(TILE_WALL, tiles[self - 2U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, tiles[self - 3U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[self - (3U * n_cols)]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, tiles[self + 1U - n_cols]);
+}
+
+void test_observe_shadowcast_ignores_radius_out_of_range(void)
+{
+    const uint32_t radii[] = {0U, SHADOWCAST_MAX_RADIUS + 1U};
+    for (uint32_t i = 0; i < 2U; i++)
+    {
+        uint32_t state[2048] = {};
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(2048U / 2U,
+                                         shadowcast_state_size(radii[i]));
+        observe_shadowcast(g_world_state, radii[i], state);
+
+        for (uint32_t j = 0; j < 2048U; j++)
+        {
+            TEST_ASSERT_EQUAL_UINT32(0U, state[j]);
+        }
+    }
+}
+
+void test_pack_tile_maps_tiles_to_packed_tiles(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_HIDDEN, pack_tile(TILE_HIDDEN));
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_WALL, pack_tile(TILE_WALL));
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_FLOOR, pack_tile(TILE_FLOOR));
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_FLOOR_OCCUPIED,
+                             pack_tile(TILE_FLOOR_OCCUPIED));
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_OPEN_DOOR, pack_tile(TILE_OPEN_DOOR));
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_OPEN_DOOR_OCCUPIED,
+                             pack_tile(TILE_OPEN_DOOR_OCCUPIED));
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_CLOSED_DOOR,
+                             pack_tile(TILE_CLOSED_DOOR));
+    TEST_ASSERT_EQUAL_UINT32(PACKED_TILE_VOID, pack_tile(TILE_VOID));
+}
+
+void test_tick_with_packed_states_matches_tick(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+        n_ticks = 4U,
+    };
+
+    static const enum Tile unpacked_tiles[] = {
+        TILE_HIDDEN,
+        TILE_CLOSED_DOOR,
+        TILE_FLOOR,
+        TILE_OPEN_DOOR,
+        TILE_VOID,
+        TILE_WALL,
+        TILE_FLOOR_OCCUPIED,
+        TILE_OPEN_DOOR_OCCUPIED,
+    };
+
+    uint32_t header[PACKED_STATE_HEADER_SIZE] = {};
+    packed_state_header(header);
+    TEST_ASSERT_EQUAL_UINT32(PACKED_STATE_VERSION, header[0]);
+    TEST_ASSERT_EQUAL_UINT32(FOV_SIZE, header[1]);
+    TEST_ASSERT_EQUAL_UINT32(FOV_SIZE, header[2]);
+    TEST_ASSERT_EQUAL_UINT32(FOV_SELF_IDX, header[3]);
+
+    const uint32_t features[] = {
+        SCRATCH_PACKED_STATES,
+        SCRATCH_PACKED_STATES | SCRATCH_OBSERVATION_CACHE,
+    };
+
+    for (uint32_t f = 0; f < 2U; f++)
+    {
+        uint32_t *world = create_crowded_world(n_rows, n_cols);
+        uint32_t *expected_world = create_crowded_world(n_rows, n_cols);
+        const uint32_t n_agents = world[0];
+
+        const size_t n_words = scratch_size(world, features[f]);
+        uint64_t *scratch = (uint64_t *)calloc(n_words, sizeof(uint64_t));
+        TEST_ASSERT_NOT_NULL(scratch);
+        init_scratch(world, scratch, features[f]);
+
+        const uint32_t size = packed_state_size();
+        uint32_t *states = (uint32_t *)calloc(
+            (size_t)n_agents * size, sizeof(uint32_t));
+        uint32_t *expected_states = (uint32_t *)calloc(
+            (size_t)n_agents * AGENT_STATE_SIZE, sizeof(uint32_t));
+        uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+        TEST_ASSERT_NOT_NULL(states);
+        TEST_ASSERT_NOT_NULL(expected_states);
+        TEST_ASSERT_NOT_NULL(actions);
+
+        for (uint32_t t = 0; t < n_ticks; t++)
+        {
+            for (uint32_t i = 0; i < n_agents; i++)
+            {
+                actions[i] = ((i * 3U) + t) % (ACTION_CLOSE_DOOR + 1U);
+            }
+
+            tick_with_scratch(world, scratch, states, actions, t);
+            tick(expected_world, expected_states, actions, t);
+
+            for (uint32_t i = 0; i < n_agents; i++)
+            {
+                const uint32_t *packed = states + ((size_t)i * size);
+                const enum Tile *expected = (const enum Tile *)(expected_states
+                    + ((size_t)i * AGENT_STATE_SIZE) + 4U);
+                for (uint32_t j = 0; j < FOV_SIZE * FOV_SIZE; j++)
+                {
+                    const uint32_t code =
+                        (packed[j / 10U] >> (3U * (j % 10U))) & 7U;
+                    TEST_ASSERT_EQUAL_UINT8(expected[j], unpacked_tiles[code]);
+                }
+            }
+        }
+
+        free(actions);
+        free(expected_states);
+        free(states);
+        free(scratch);
+        free(expected_world);
+        free(world);
+    }
+}
+
+void test_observation_planes_encode_tiles_by_channel(void)
+{
+    static const enum Tile tiles[] = {
+        TILE_HIDDEN,
+        TILE_WALL,
+        TILE_FLOOR,
+        TILE_FLOOR_OCCUPIED,
+        TILE_OPEN_DOOR,
+        TILE_OPEN_DOOR_OCCUPIED,
+        TILE_CLOSED_DOOR,
+    };
+
+    // hot channels of each tile, where bit `c` refers to channel `c`
+    static const uint32_t channels[] = {
+        1U << PLANE_HIDDEN,
+        1U << PLANE_WALL,
+        1U << PLANE_FLOOR,
+        (1U << PLANE_FLOOR) | (1U << PLANE_OCCUPIED),
+        1U << PLANE_OPEN_DOOR,
+        (1U << PLANE_OPEN_DOOR) | (1U << PLANE_OCCUPIED),
+        1U << PLANE_CLOSED_DOOR,
+    };
+
+    enum : uint32_t
+    {
+        n_agents = 2U,
+        n_tiles = FOV_SIZE * FOV_SIZE,
+        n_entries = PLANE_CHANNELS * n_tiles,
+    };
+
+    uint32_t states[n_agents * AGENT_STATE_SIZE] = {};
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        uint32_t *state = states + (i * AGENT_STATE_SIZE);
+        state[0] = AGENT_STATE_VERSION;
+        state[1] = FOV_SIZE;
+        state[2] = FOV_SIZE;
+        state[3] = FOV_SELF_IDX;
+
+        enum Tile *fov = (enum Tile *)(state + 4U);
+        for (uint32_t j = 0; j < n_tiles; j++)
+        {
+            fov[j] = tiles[(i + j) % 7U];
+        }
+    }
+
+    float planes_f32[n_agents * n_entries];
+    uint8_t planes_u8[n_agents * n_entries];
+    observation_planes_f32(states, n_agents, planes_f32);
+    observation_planes_u8(states, n_agents, planes_u8);
+
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        for (uint32_t c = 0; c < PLANE_CHANNELS; c++)
+        {
+            for (uint32_t j = 0; j < n_tiles; j++)
+            {
+                const uint32_t expected = (channels[(i + j) % 7U] >> c) & 1U;
+                const size_t entry = (i * n_entries) + (c * n_tiles) + j;
+                TEST_ASSERT_EQUAL_UINT8(expected, planes_u8[entry]);
+                TEST_ASSERT_EQUAL_FLOAT((float)expected, planes_f32[entry]);
+            }
+        }
+    }
+}
+
+void test_frame_stack_keeps_latest_frames(void)
+{
+    enum : uint32_t
+    {
+        n_frames = 3U,
+        n_ticks = 5U,
+        n_agents = 2U,
+        frame_size = n_agents * AGENT_STATE_SIZE,
+    };
+
+    uint32_t *expected_world = create_world();
+    TEST_ASSERT_NOT_NULL(expected_world);
+
+    const size_t n_words =
+        frame_stack_size(g_world_state, n_frames, AGENT_STATE_SIZE);
+    TEST_ASSERT_EQUAL_size_t(6U + (n_frames * frame_size), n_words);
+    uint32_t *frames = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(frames);
+    init_frame_stack(g_world_state, frames, n_frames, AGENT_STATE_SIZE);
+
+    uint32_t expected_states[n_ticks][frame_size] = {};
+    const uint32_t actions[n_agents] = {ACTION_MOVE_DOWN, ACTION_TURN_90};
+    for (uint32_t t = 0; t < n_ticks; t++)
+    {
+        TEST_ASSERT_TRUE(
+            tick_with_frame_stack(g_world_state, NULL, frames, actions, t));
+        tick(expected_world, expected_states[t], actions, t);
+
+        for (uint32_t age = 0; age < n_frames; age++)
+        {
+            const uint32_t *frame = frame_stack_frame(frames, age);
+            if (age <= t)
+            {
+                TEST_ASSERT_EQUAL_UINT32_ARRAY(
+                    expected_states[t - age], frame, frame_size);
+            }
+            else
+            {
+                TEST_ASSERT_EACH_EQUAL_UINT32(0U, frame, frame_size);
+            }
+        }
+    }
+
+    // frames of each agent from the oldest to the latest one
+    uint32_t stacked[n_agents][n_frames][AGENT_STATE_SIZE] = {};
+    stack_frames(frames, &stacked[0][0][0]);
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        for (uint32_t k = 0; k < n_frames; k++)
+        {
+            const uint32_t t = n_ticks - n_frames + k;
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(
+                expected_states[t] + (i * AGENT_STATE_SIZE),
+                stacked[i][k],
+                AGENT_STATE_SIZE);
+        }
+    }
+
+    free(frames);
+    free(expected_world);
+}
+
+void test_frame_stack_with_observation_cache_matches_tick(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 48U,
+        n_cols = 48U,
+        n_frames = 2U,
+        n_ticks = 6U,
+    };
+
+    uint32_t *world = create_crowded_world(n_rows, n_cols);
+    uint32_t *expected_world = create_crowded_world(n_rows, n_cols);
+    const uint32_t n_agents = world[0];
+
+    const size_t n_scratch = scratch_size(world, SCRATCH_OBSERVATION_CACHE);
+    uint64_t *scratch = (uint64_t *)calloc(n_scratch, sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(scratch);
+    init_scratch(world, scratch, SCRATCH_OBSERVATION_CACHE);
+
+    const size_t n_words = frame_stack_size(world, n_frames, AGENT_STATE_SIZE);
+    uint32_t *frames = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+    uint32_t *expected_states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *actions = (uint32_t *)calloc(n_agents, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(frames);
+    TEST_ASSERT_NOT_NULL(expected_states);
+    TEST_ASSERT_NOT_NULL(actions);
+
+    for (uint32_t t = 0; t < n_ticks; t++)
+    {
+        // restarts the frame stack while the observation cache is warm
+        if (t % 3U == 0)
+        {
+            init_frame_stack(world, frames, n_frames, AGENT_STATE_SIZE);
+        }
+
+        // most agents idle in every other tick
+        for (uint32_t i = 0; i < n_agents; i++)
+        {
+            actions[i] = (t % 2U == 0 || i % 16U == 0)
+                ? ((i * 5U) + t) % (ACTION_CLOSE_DOOR + 1U)
+                : ACTION_NONE;
+        }
+
+        TEST_ASSERT_TRUE(
+            tick_with_frame_stack(world, scratch, frames, actions, t));
+        tick(expected_world, expected_states, actions, t);
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            expected_states, frame_stack_frame(frames, 0U), n_states);
+    }
+
+    free(actions);
+    free(expected_states);
+    free(frames);
+    free(scratch);
+    free(expected_world);
+    free(world);
+}
+
+void test_frame_stack_with_packed_states_copies_skipped_agents(void)
+{
+    enum : uint32_t
+    {
+        n_frames = 2U,
+        n_agents = 2U,
+    };
+
+    uint64_t *scratch =
+        create_scratch(SCRATCH_OBSERVATION_CACHE | SCRATCH_PACKED_STATES);
+
+    const uint32_t size = packed_state_size();
+    const size_t n_words = frame_stack_size(g_world_state, n_frames, size);
+    uint32_t *frames = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(frames);
+    init_frame_stack(g_world_state, frames, n_frames, size);
+
+    const uint32_t idle[n_agents] = {ACTION_NONE, ACTION_NONE};
+    TEST_ASSERT_TRUE(
+        tick_with_frame_stack(g_world_state, scratch, frames, idle, 1U));
+
+    // the agents look beyond the top of the map, i.e., at hidden tiles only
+    uint32_t *frame = frame_stack_frame(frames, 0U);
+    TEST_ASSERT_EQUAL_UINT32(0U, frame[0]);
+    TEST_ASSERT_EQUAL_UINT32(0U, frame[size]);
+
+    // idle agents copy their states from the previous frame, as marked
+    frame[size - 1U] ^= 1U;
+    TEST_ASSERT_TRUE(
+        tick_with_frame_stack(g_world_state, scratch, frames, idle, 2U));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        frame, frame_stack_frame(frames, 0U), n_agents * size);
+
+    free(frames);
+    free(scratch);
+}
+
+void test_frame_stack_of_other_states_is_not_ticked(void)
+{
+    uint64_t *scratch = create_scratch(SCRATCH_PACKED_STATES);
+    uint32_t *expected_world = create_world();
+    TEST_ASSERT_NOT_NULL(expected_world);
+
+    // frames of unpacked states, and of packed states without packing
+    const uint32_t sizes[] = {AGENT_STATE_SIZE, PACKED_STATE_SIZE};
+    uint64_t *scratches[] = {scratch, NULL};
+    for (uint32_t i = 0; i < 2U; i++)
+    {
+        const size_t n_words = frame_stack_size(g_world_state, 2U, sizes[i]);
+        uint32_t *frames = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+        uint32_t *expected = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+        TEST_ASSERT_NOT_NULL(frames);
+        TEST_ASSERT_NOT_NULL(expected);
+        init_frame_stack(g_world_state, frames, 2U, sizes[i]);
+        memcpy(expected, frames, n_words * sizeof(uint32_t));
+
+        const uint32_t actions[] = {ACTION_MOVE_DOWN, ACTION_MOVE_DOWN};
+        TEST_ASSERT_FALSE(tick_with_frame_stack(
+            g_world_state, scratches[i], frames, actions, 1U));
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, frames, n_words);
+        TEST_ASSERT_EQUAL_MEMORY(
+            expected_world, g_world_state, world_state_bytes(g_world_state));
+
+        free(expected);
+        free(frames);
+    }
+
+    free(expected_world);
+    free(scratch);
+}
+
+void test_frame_stack_of_single_frame_keeps_skipped_agents(void)
+{
+    enum : uint32_t
+    {
+        n_agents = 2U,
+        frame_size = n_agents * AGENT_STATE_SIZE,
+    };
+
+    uint64_t *scratch = create_scratch(SCRATCH_OBSERVATION_CACHE);
+    uint32_t *expected_world = create_world();
+    TEST_ASSERT_NOT_NULL(expected_world);
+
+    const size_t n_words =
+        frame_stack_size(g_world_state, 1U, AGENT_STATE_SIZE);
+    uint32_t *frames = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(frames);
+    init_frame_stack(g_world_state, frames, 1U, AGENT_STATE_SIZE);
+
+    // agent 1 idles in the second tick and keeps its state
+    const uint32_t actions[][n_agents] = {
+        {ACTION_MOVE_DOWN, ACTION_TURN_90},
+        {ACTION_MOVE_DOWN, ACTION_NONE},
+    };
+    uint32_t expected_states[frame_size] = {};
+    for (uint32_t t = 0; t < 2U; t++)
+    {
+        TEST_ASSERT_TRUE(tick_with_frame_stack(
+            g_world_state, scratch, frames, actions[t], t));
+        tick(expected_world, expected_states, actions[t], t);
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(
+            expected_states, frame_stack_frame(frames, 0U), frame_size);
+    }
+
+    free(frames);
+    free(expected_world);
+    free(scratch);
+}
+
+[[nodiscard]] static uint32_t *create_empty_world(const uint32_t n_rows,
+                                                  const uint32_t n_cols,
+                                                  const uint32_t n_agents)
+{
+    const uint32_t n_tiles = n_rows * n_cols;
+    const size_t n_words = 3U + (2U * (size_t)n_agents)
+        + ((n_tiles + sizeof(uint32_t) - 1U) / sizeof(uint32_t));
+
+    uint32_t *world = (uint32_t *)calloc(n_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(world);
+
+    world[0] = n_agents;
+    world[1U + (2U * n_agents)] = n_rows;
+    world[2U + (2U * n_agents)] = n_cols;
+    return world;
+}
+
+void test_generate_dungeon_connects_all_floor(void)
+{
+    enum : uint32_t
+    {
+        n_sizes = 3U,
+        n_seeds = 8U,
+        n_agents = 16U,
+    };
+    const uint32_t sizes[n_sizes][2] = {{16U, 16U}, {33U, 57U}, {64U, 64U}};
+
+    for (uint32_t i = 0; i < n_sizes * n_seeds; i++)
+    {
+        const uint32_t n_rows = sizes[i / n_seeds][0];
+        const uint32_t n_cols = sizes[i / n_seeds][1];
+        const uint32_t n_tiles = n_rows * n_cols;
+        uint32_t *world_state = create_empty_world(n_rows, n_cols, n_agents);
+        TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(world_state, i));
+
+        const struct World world = load_world(world_state, 0U);
+        const enum Tile *tiles = world.map.tiles;
+        for (uint32_t j = 0; j < n_agents; j++)
+        {
+            TEST_ASSERT_EQUAL(TILE_FLOOR_OCCUPIED,
+                              tiles[world.agents.positions[j]]);
+            TEST_ASSERT_LESS_THAN_UINT32(4U, world.agents.orientations[j]);
+        }
+
+        uint32_t n_floor = 0;
+        uint32_t n_occupied = 0;
+        uint32_t n_doors = 0;
+        for (uint32_t j = 0; j < n_tiles; j++)
+        {
+            const uint32_t row = j / n_cols;
+            const uint32_t col = j % n_cols;
+            if (row == 0 || col == 0 || row == n_rows - 1U
+                || col == n_cols - 1U)
+            {
+                TEST_ASSERT_EQUAL(TILE_WALL, tiles[j]);
+            }
+            n_floor += (tiles[j] != TILE_WALL) ? 1U : 0U;
+            n_occupied += (tiles[j] == TILE_FLOOR_OCCUPIED) ? 1U : 0U;
+            n_doors += (tiles[j] == TILE_CLOSED_DOOR) ? 1U : 0U;
+        }
+        TEST_ASSERT_EQUAL_UINT32(n_agents, n_occupied);
+        TEST_ASSERT_GREATER_THAN_UINT32(0U, n_doors);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(n_tiles / 10U, n_floor);
+
+        // flood fill through floor and doors from the first agent
+        uint32_t *queue = (uint32_t *)calloc(n_tiles, sizeof(uint32_t));
+        bool *is_reached = (bool *)calloc(n_tiles, sizeof(bool));
+        TEST_ASSERT_NOT_NULL(queue);
+        TEST_ASSERT_NOT_NULL(is_reached);
+
+        uint32_t n_queued = 0;
+        queue[n_queued++] = world.agents.positions[0];
+        is_reached[queue[0]] = true;
+        for (uint32_t head = 0; head < n_queued; head++)
+        {
+            const uint32_t pos = queue[head];
+            const uint32_t neighbors[4] = {
+                pos - n_cols, pos + n_cols, pos - 1U, pos + 1U};
+            for (uint32_t k = 0; k < 4U; k++)
+            {
+                const uint32_t next = neighbors[k];
+                if (tiles[next] != TILE_WALL && !is_reached[next])
+                {
+                    is_reached[next] = true;
+                    queue[n_queued++] = next;
+                }
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT32(n_floor, n_queued);
+
+        free(is_reached);
+        free(queue);
+        free(world_state);
+    }
+}
+
+void test_generate_dungeon_rejects_maps_without_room(void)
+{
+    const uint32_t sizes[][2] = {{1U, 8U}, {2U, 8U}, {3U, 3U}, {8U, 3U}};
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        const uint32_t n_rows = sizes[i][0];
+        const uint32_t n_cols = sizes[i][1];
+        uint32_t *world_state = create_empty_world(n_rows, n_cols, 1U);
+        uint32_t *expected = create_empty_world(n_rows, n_cols, 1U);
+        const size_t n_words = world_state_words(world_state);
+
+        TEST_ASSERT_EQUAL_UINT32(0U, generate_dungeon(world_state, i));
+        TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, world_state, n_words);
+
+        free(expected);
+        free(world_state);
+    }
+}
+
+void test_generate_dungeon_fills_small_map_with_agents(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 16U,
+        n_cols = 16U,
+        n_agents = n_rows * n_cols,
+    };
+
+    // more agents than floor tiles occupy all of them
+    uint32_t *world_state = create_empty_world(n_rows, n_cols, n_agents);
+    const uint32_t n_placed = generate_dungeon(world_state, 5U);
+    TEST_ASSERT_LESS_THAN_UINT32(n_agents, n_placed);
+
+    const struct World world = load_world(world_state, 0U);
+    uint32_t n_occupied = 0U;
+    for (uint32_t i = 0; i < n_rows * n_cols; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(TILE_FLOOR, world.map.tiles[i]);
+        n_occupied += (world.map.tiles[i] == TILE_FLOOR_OCCUPIED) ? 1U : 0U;
+    }
+    TEST_ASSERT_EQUAL_UINT32(n_placed, n_occupied);
+
+    free(world_state);
+}
+
+void test_generate_dungeon_depends_on_seed_only(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 40U,
+        n_cols = 48U,
+        n_agents = 8U,
+    };
+
+    uint32_t *world_state = create_empty_world(n_rows, n_cols, n_agents);
+    uint32_t *expected = create_empty_world(n_rows, n_cols, n_agents);
+    uint32_t *other = create_empty_world(n_rows, n_cols, n_agents);
+    const size_t n_words = 3U + (2U * n_agents) + ((n_rows * n_cols) / 4U);
+
+    TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(world_state, 42U));
+    TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(expected, 42U));
+    TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(other, 43U));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, world_state, n_words);
+    TEST_ASSERT_NOT_EQUAL(
+        0, memcmp(expected, other, n_words * sizeof(uint32_t)));
+
+    // generating into a padded world state adds the halo only
+    const size_t n_padded_words = padded_world_state_size(world_state);
+    uint32_t *padded = (uint32_t *)calloc(n_padded_words, sizeof(uint32_t));
+    uint32_t *expected_padded =
+        (uint32_t *)calloc(n_padded_words, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(padded);
+    TEST_ASSERT_NOT_NULL(expected_padded);
+
+    pad_world_state(other, padded);
+    pad_world_state(world_state, expected_padded);
+    TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(padded, 42U));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_padded, padded, n_padded_words);
+
+    free(expected_padded);
+    free(padded);
+    free(other);
+    free(expected);
+    free(world_state);
+}
+
+void test_tick_batch_with_reset_restarts_done_worlds(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 16U,
+        n_cols = 20U,
+        n_agents = 4U,
+        n_worlds = 2U,
+    };
+    const size_t n_words = 3U + (2U * n_agents) + ((n_rows * n_cols) / 4U);
+    const size_t n_snapshot_words = 2U + n_words;
+    const size_t n_states = (size_t)n_worlds * n_agents * AGENT_STATE_SIZE;
+
+    uint32_t *worlds = (uint32_t *)calloc(n_worlds * n_words, sizeof(uint32_t));
+    uint32_t *expected_worlds =
+        (uint32_t *)calloc(n_worlds * n_words, sizeof(uint32_t));
+    uint32_t *snapshots =
+        (uint32_t *)calloc(n_worlds * n_snapshot_words, sizeof(uint32_t));
+    uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *expected_states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(worlds);
+    TEST_ASSERT_NOT_NULL(expected_worlds);
+    TEST_ASSERT_NOT_NULL(snapshots);
+    TEST_ASSERT_NOT_NULL(states);
+    TEST_ASSERT_NOT_NULL(expected_states);
+
+    for (uint32_t i = 0; i < n_worlds; i++)
+    {
+        uint32_t *world = create_empty_world(n_rows, n_cols, n_agents);
+        TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(world, 7U + i));
+        TEST_ASSERT_EQUAL_size_t(n_snapshot_words, snapshot_size(world));
+        snapshot_world(world, snapshots + (i * n_snapshot_words));
+        copy_bytes(worlds + (i * n_words), world, n_words * sizeof(uint32_t));
+        free(world);
+    }
+
+    const uint32_t actions[n_worlds * n_agents] = {4U, 5U, 6U, 7U, 4U, 5U, 6U};
+    const uint32_t seeds[n_worlds] = {3U, 5U};
+    uint32_t dones[n_worlds] = {0U, 0U};
+    tick_batch_with_reset(
+        worlds, n_worlds, states, actions, seeds, dones, snapshots);
+    copy_bytes(expected_worlds, worlds, n_worlds * n_words * sizeof(uint32_t));
+
+    // world 0 restarts from its snapshot, world 1 ticks as in `tick_batch()`
+    dones[0] = 1U;
+    tick_batch_with_reset(
+        worlds, n_worlds, states, actions, seeds, dones, snapshots);
+    tick_batch(expected_worlds, n_worlds, expected_states, actions, seeds);
+    copy_bytes(expected_worlds, snapshots + 2U, n_words * sizeof(uint32_t));
+
+    const uint32_t no_actions[n_agents] = {0};
+    tick(expected_worlds, expected_states, no_actions, 0U);
+    TEST_ASSERT_EQUAL_UINT32(0U, dones[0]);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected_worlds, worlds, n_worlds * n_words);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_states, states, n_states);
+
+    // without snapshots, world 0 is regenerated as by `generate_dungeon()`
+    dones[0] = 1U;
+    tick_batch_with_reset(
+        worlds, n_worlds, states, actions, seeds, dones, NULL);
+    TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(expected_worlds, 3U));
+    tick(expected_worlds, expected_states, no_actions, 0U);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_worlds, worlds, n_words);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(
+        expected_states, states, (size_t)n_agents * AGENT_STATE_SIZE);
+
+    free(expected_states);
+    free(states);
+    free(snapshots);
+    free(expected_worlds);
+    free(worlds);
+}
+
+void test_tick_batch_with_reset_keeps_flags_of_failed_resets(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 4U,
+        n_cols = 4U,
+        n_agents = 8U,
+    };
+    const size_t n_words = 3U + (2U * n_agents) + ((n_rows * n_cols) / 4U);
+    const size_t n_states = (size_t)n_agents * AGENT_STATE_SIZE;
+
+    uint32_t *world = create_empty_world(n_rows, n_cols, n_agents);
+    uint32_t *expected = create_empty_world(n_rows, n_cols, n_agents);
+    uint32_t *snapshot =
+        (uint32_t *)calloc(snapshot_size(world), sizeof(uint32_t));
+    uint32_t *states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    uint32_t *expected_states = (uint32_t *)calloc(n_states, sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(snapshot);
+    TEST_ASSERT_NOT_NULL(states);
+    TEST_ASSERT_NOT_NULL(expected_states);
+
+    // the map has no room for all agents
+    const uint32_t actions[n_agents] = {0};
+    const uint32_t seeds[] = {3U};
+    uint32_t dones[] = {1U};
+    tick_batch_with_reset(world, 1U, states, actions, seeds, dones, NULL);
+    TEST_ASSERT_EQUAL_UINT32(1U, dones[0]);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_states, states, n_states);
+
+    // the snapshot is of another version and would revert agent 0
+    snapshot_world(world, snapshot);
+    snapshot[0] = SNAPSHOT_VERSION + 1U;
+    world[1] = 5U;
+    copy_bytes(expected, world, n_words * sizeof(uint32_t));
+    tick_batch_with_reset(world, 1U, states, actions, seeds, dones, snapshot);
+    TEST_ASSERT_EQUAL_UINT32(1U, dones[0]);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, world, n_words);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected_states, states, n_states);
+
+    free(expected_states);
+    free(states);
+    free(snapshot);
+    free(expected);
+    free(world);
+}
+
+void test_distance_field_passes_agents_but_not_closed_doors(void)
+{
+    // walls in column 3 with a closed door in row 5, goal at row 0, col 6
+    for (uint32_t row = 0; row < 6U; row++)
+    {
+        g_map.tiles[(row * 7U) + 3U] = (row == 5U) ? TILE_CLOSED_DOOR
+            : (row == 2U)                          ? TILE_OPEN_DOOR
+                                                   : TILE_WALL;
+    }
+    move_agent1(16U);
+
+    uint64_t *workspace = (uint64_t *)calloc(
+        distance_field_workspace_size(g_world_state), sizeof(uint64_t));
+    uint32_t distances[42];
+    uint32_t flow[42];
+    TEST_ASSERT_NOT_NULL(workspace);
+
+    const uint32_t goal = 6U;
+    distance_field(
+        g_world_state, workspace, &goal, 1U, distances, flow, SEARCH_QUEUE);
+
+    // through the open door and past agent 1
+    TEST_ASSERT_EQUAL_UINT32(0U, distances[6]);
+    TEST_ASSERT_EQUAL_UINT32(5U, distances[17]);
+    TEST_ASSERT_EQUAL_UINT32(6U, distances[16]);
+    TEST_ASSERT_EQUAL_UINT32(7U, distances[15]);
+    TEST_ASSERT_EQUAL_UINT32(10U, distances[0]);
+    TEST_ASSERT_EQUAL_UINT32(11U, distances[35]);
+    TEST_ASSERT_EQUAL_UINT32(DISTANCE_UNREACHABLE, distances[3]);
+    TEST_ASSERT_EQUAL_UINT32(DISTANCE_UNREACHABLE, distances[38]);
+
+    TEST_ASSERT_EQUAL_UINT32(ACTION_NONE, flow[6]);
+    TEST_ASSERT_EQUAL_UINT32(ACTION_NONE, flow[3]);
+    TEST_ASSERT_EQUAL_UINT32(ACTION_MOVE_RIGHT, flow[16]);
+    TEST_ASSERT_EQUAL_UINT32(ACTION_MOVE_UP, flow[13]);
+    TEST_ASSERT_EQUAL_UINT32(ACTION_MOVE_UP, flow[35]);
+    TEST_ASSERT_EQUAL_UINT32(ACTION_MOVE_RIGHT, flow[17]);
+
+    free(workspace);
+}
+
+// relaxes distances until they are stable, as a reference for the searches
+static void relax_distances(uint32_t *world_state,
+                            const uint32_t goal,
+                            uint32_t *distances)
+{
+    const struct World world = load_world(world_state, 0U);
+    const size_t n_tiles = map_tiles(&world.map);
+    for (size_t i = 0; i < n_tiles; i++)
+    {
+        distances[i] = (i == goal) ? 0U : DISTANCE_UNREACHABLE;
+    }
+
+    for (bool is_changed = true; is_changed;)
+    {
+        is_changed = false;
+        for (uint32_t pos = 0; pos < n_tiles; pos++)
+        {
+            for (uint32_t heading = 0;
+                 heading < 4U && is_tile_passable(world.map.tiles[pos]);
+                 heading++)
+            {
+                const struct Pose pose = {
+                    .position = pos, .heading = (enum Orientation)heading};
+                const uint32_t next = ahead(world.map, pose);
+                if (distances[next] != DISTANCE_UNREACHABLE
+                    && distances[next] + 1U < distances[pos])
+                {
+                    distances[pos] = distances[next] + 1U;
+                    is_changed = true;
+                }
+            }
+        }
+    }
+}
+
+void test_distance_field_searches_match_reference(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 33U,
+        n_cols = 70U,
+        n_agents = 12U,
+    };
+
+    uint32_t *legacy = create_empty_world(n_rows, n_cols, n_agents);
+    TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(legacy, 11U));
+    uint32_t *padded =
+        (uint32_t *)calloc(padded_world_state_size(legacy), sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(padded);
+    pad_world_state(legacy, padded);
+
+    uint32_t *worlds[] = {legacy, padded};
+    for (uint32_t i = 0; i < 2U; i++)
+    {
+        const struct World world = load_world(worlds[i], 0U);
+        const size_t n_tiles = map_tiles(&world.map);
+        uint64_t *workspace = (uint64_t *)calloc(
+            distance_field_workspace_size(worlds[i]), sizeof(uint64_t));
+        uint32_t *expected = (uint32_t *)calloc(n_tiles, sizeof(uint32_t));
+        uint32_t *distances = (uint32_t *)calloc(n_tiles, sizeof(uint32_t));
+        uint32_t *flow = (uint32_t *)calloc(n_tiles, sizeof(uint32_t));
+        TEST_ASSERT_NOT_NULL(workspace);
+        TEST_ASSERT_NOT_NULL(expected);
+        TEST_ASSERT_NOT_NULL(distances);
+        TEST_ASSERT_NOT_NULL(flow);
+
+        const uint32_t goal = world.agents.positions[0];
+        relax_distances(worlds[i], goal, expected);
+        for (uint32_t method = SEARCH_QUEUE; method <= SEARCH_BITBOARD;
+             method++)
+        {
+            distance_field(worlds[i],
+                           workspace,
+                           &goal,
+                           1U,
+                           distances,
+                           flow,
+                           (enum SearchMethod)method);
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, distances, n_tiles);
+
+            // the flow of each reachable tile leads one move closer
+            for (uint32_t pos = 0; pos < n_tiles; pos++)
+            {
+                if (pos == goal || distances[pos] == DISTANCE_UNREACHABLE)
+                {
+                    TEST_ASSERT_EQUAL_UINT32(ACTION_NONE, flow[pos]);
+                    continue;
+                }
+
+                const struct Pose pose = {
+                    .position = pos,
+                    .heading = (enum Orientation)(flow[pos] - ACTION_MOVE_UP)};
+                TEST_ASSERT_EQUAL_UINT32(distances[pos] - 1U,
+                                         distances[ahead(world.map, pose)]);
+            }
+        }
+
+        free(flow);
+        free(distances);
+        free(expected);
+        free(workspace);
+    }
+
+    free(padded);
+    free(legacy);
+}
+
+[[nodiscard]] static uint32_t *create_path_cache(const uint32_t max_length)
+{
+    uint32_t *path_cache = (uint32_t *)calloc(
+        path_cache_size(g_world_state, max_length), sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(path_cache);
+    init_path_cache(g_world_state, path_cache, max_length);
+    return path_cache;
+}
+
+void test_next_path_actions_open_doors_on_the_way(void)
+{
+    // walls in column 3 with a closed door in the last row
+    for (uint32_t row = 0; row < 6U; row++)
+    {
+        g_map.tiles[(row * 7U) + 3U] =
+            (row == 5U) ? TILE_CLOSED_DOOR : TILE_WALL;
+    }
+    move_agent1(6U);
+
+    uint32_t *path_cache = create_path_cache(32U);
+    uint64_t *workspace = (uint64_t *)calloc(
+        path_workspace_size(g_world_state), sizeof(uint64_t));
+    uint32_t agent_states[2U * AGENT_STATE_SIZE];
+    TEST_ASSERT_NOT_NULL(workspace);
+
+    const uint32_t request[2] = {0U, 41U};
+    uint32_t n_searches = 0;
+    uint32_t n_ticks = 0;
+    uint32_t opened_at = 0;
+    for (; g_agents.positions[0] != 41U && n_ticks < 32U; n_ticks++)
+    {
+        uint32_t actions[2] = {ACTION_NONE, ACTION_NONE};
+        n_searches += next_path_actions(
+            g_world_state, path_cache, workspace, request, 1U, actions);
+        if (actions[0] == ACTION_OPEN_DOOR)
+        {
+            TEST_ASSERT_EQUAL_UINT32(37U, g_agents.positions[0]);
+            TEST_ASSERT_EQUAL_UINT32(ORIENTATION_RIGHT,
+                                     g_agents.orientations[0]);
+            opened_at = n_ticks;
+        }
+        tick(g_world_state, agent_states, actions, n_ticks);
+    }
+
+    // 11 moves, a turn to face the door and opening it
+    TEST_ASSERT_EQUAL_UINT32(13U, n_ticks);
+    TEST_ASSERT_NOT_EQUAL(0U, opened_at);
+    TEST_ASSERT_EQUAL_UINT32(1U, n_searches);
+    TEST_ASSERT_EQUAL(TILE_OPEN_DOOR, g_map.tiles[38]);
+
+    uint32_t action = ACTION_MOVE_UP;
+    TEST_ASSERT_EQUAL_UINT32(
+        0U,
+        next_path_actions(
+            g_world_state, path_cache, workspace, request, 1U, &action));
+    TEST_ASSERT_EQUAL_UINT32(ACTION_NONE, action);
+
+    free(workspace);
+    free(path_cache);
+}
+
+void test_next_path_actions_search_again_after_edits_on_path(void)
+{
+    uint32_t *path_cache = create_path_cache(32U);
+    uint64_t *workspace = (uint64_t *)calloc(
+        path_workspace_size(g_world_state), sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(workspace);
+
+    uint32_t request[2] = {0U, 41U};
+    uint32_t action = ACTION_NONE;
+    TEST_ASSERT_EQUAL_UINT32(
+        1U,
+        next_path_actions(
+            g_world_state, path_cache, workspace, request, 1U, &action));
+    TEST_ASSERT_EQUAL_UINT32(
+        0U,
+        next_path_actions(
+            g_world_state, path_cache, workspace, request, 1U, &action));
+
+    // edits and agents off the path keep it
+    const struct PathRecord record = path_record(path_cache, 0U);
+    bool is_on_path[42] = {false};
+    for (uint32_t i = 0; i < *record.n_tiles; i++)
+    {
+        is_on_path[record.tiles[i]] = true;
+    }
+    TEST_ASSERT_EQUAL_UINT32(12U, *record.n_tiles);
+
+    uint32_t off_path = 0;
+    while (is_on_path[off_path] || off_path == 1U)
+    {
+        off_path++;
+    }
+    g_map.tiles[off_path] = TILE_WALL;
+    move_agent1(record.tiles[5]);
+    TEST_ASSERT_EQUAL_UINT32(
+        0U,
+        next_path_actions(
+            g_world_state, path_cache, workspace, request, 1U, &action));
+
+    // a wall on the path leads around it
+    const uint32_t blocked = record.tiles[3];
+    g_map.tiles[blocked] = TILE_WALL;
+    TEST_ASSERT_EQUAL_UINT32(
+        1U,
+        next_path_actions(
+            g_world_state, path_cache, workspace, request, 1U, &action));
+    for (uint32_t i = 0; i < *record.n_tiles; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(blocked, record.tiles[i]);
+    }
+
+    // goals behind walls are searched on every call
+    request[1] = off_path;
+    for (uint32_t i = 0; i < 2U; i++)
+    {
+        action = ACTION_MOVE_UP;
+        TEST_ASSERT_EQUAL_UINT32(
+            1U,
+            next_path_actions(
+                g_world_state, path_cache, workspace, request, 1U, &action));
+        TEST_ASSERT_EQUAL_UINT32(ACTION_NONE, action);
+    }
+
+    free(workspace);
+    free(path_cache);
+}
+
+[[nodiscard]] static uint64_t *create_exploration_memory(
+    const uint32_t n_groups,
+    const uint32_t max_chunks)
+{
+    uint64_t *memory = (uint64_t *)calloc(
+        exploration_memory_size(n_groups, max_chunks), sizeof(uint64_t));
+    TEST_ASSERT_NOT_NULL(memory);
+    init_exploration_memory(memory, n_groups, max_chunks);
+    return memory;
+}
+
+void test_update_exploration_remembers_visible_tiles(void)
+{
+    uint64_t *memory = create_exploration_memory(2U, 4U);
+    uint32_t agent_states[2U * AGENT_STATE_SIZE];
+    const uint32_t actions[2] = {ACTION_NONE, ACTION_TURN_90};
+    tick(g_world_state, agent_states, actions, 0U);
+    TEST_ASSERT_EQUAL_UINT32(
+        0U, update_exploration(g_world_state, memory, NULL, agent_states));
+
+    // each agent remembers the visible tiles of its FoV
+    uint8_t tiles[42];
+    for (uint32_t i = 0; i < 2U; i++)
+    {
+        uint32_t n_visible = 0;
+        const enum Tile *fov = (const enum Tile *)(agent_states
+                                                   + (i * AGENT_STATE_SIZE)
+                                                   + 4U);
+        for (uint32_t j = 0; j < FOV_SIZE * FOV_SIZE; j++)
+        {
+            n_visible += (fov[j] != TILE_HIDDEN) ? 1U : 0U;
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(n_visible,
+                                 recall_map(g_world_state, memory, i, tiles));
+        TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR_OCCUPIED,
+                                tiles[g_agents.positions[i]]);
+        for (uint32_t j = 0; j < 42U; j++)
+        {
+            if (tiles[j] != TILE_HIDDEN)
+            {
+                TEST_ASSERT_EQUAL_UINT8(g_map.tiles[j], tiles[j]);
+            }
+        }
+    }
+
+    // agent 0 looks up from the top row, agent 1 to the right
+    TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, tiles[7]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[(2U * 7U) + 3U]);
+    TEST_ASSERT_EQUAL_UINT32(1U, recall_map(g_world_state, memory, 0U, tiles));
+    TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, tiles[7]);
+
+    free(memory);
+}
+
+void test_update_exploration_keeps_last_seen_tiles_of_teams(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 24U,
+        n_cols = 40U,
+        n_agents = 8U,
+        n_ticks = 24U,
+    };
+
+    uint32_t *legacy = create_empty_world(n_rows, n_cols, n_agents);
+    TEST_ASSERT_EQUAL_UINT32(n_agents, generate_dungeon(legacy, 5U));
+    uint32_t *padded =
+        (uint32_t *)calloc(padded_world_state_size(legacy), sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(padded);
+    pad_world_state(legacy, padded);
+
+    const uint32_t teams[n_agents] = {0U, 1U, 0U, 1U, 0U, 1U, 0U, 1U};
+    uint64_t *legacy_memory = create_exploration_memory(2U, 16U);
+    uint64_t *padded_memory = create_exploration_memory(2U, 16U);
+    uint64_t *small_memory = create_exploration_memory(2U, 1U);
+    uint32_t agent_states[n_agents * AGENT_STATE_SIZE];
+    uint32_t actions[n_agents];
+    uint32_t n_dropped = 0;
+    for (uint32_t i = 0; i < n_ticks; i++)
+    {
+        for (uint32_t j = 0; j < n_agents; j++)
+        {
+            actions[j] = ((i + j) % 3U == 0) ? ACTION_TURN_90
+                                             : ACTION_MOVE_UP + ((i / 4U) % 4U);
+        }
+
+        tick(padded, agent_states, actions, i);
+        TEST_ASSERT_EQUAL_UINT32(
+            0U, update_exploration(padded, padded_memory, teams, agent_states));
+        tick(legacy, agent_states, actions, i);
+        TEST_ASSERT_EQUAL_UINT32(
+            0U, update_exploration(legacy, legacy_memory, teams, agent_states));
+        n_dropped +=
+            update_exploration(legacy, small_memory, teams, agent_states);
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, n_dropped);
+
+    // memories do not depend on the layout, and tiles are kept once out of
+    // sight, where agents may have left
+    const struct World world = load_world(legacy, 0U);
+    uint8_t tiles[n_rows * n_cols];
+    uint8_t padded_tiles[n_rows * n_cols];
+    for (uint32_t team = 0; team < 2U; team++)
+    {
+        const uint32_t n_explored =
+            recall_map(legacy, legacy_memory, team, tiles);
+        TEST_ASSERT_EQUAL_UINT32(
+            n_explored, recall_map(padded, padded_memory, team, padded_tiles));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(tiles, padded_tiles, n_rows * n_cols);
+        TEST_ASSERT_GREATER_THAN_UINT32(0U, n_explored);
+
+        for (uint32_t i = 0; i < n_rows * n_cols; i++)
+        {
+            if (tiles[i] != TILE_HIDDEN)
+            {
+                TEST_ASSERT_EQUAL_UINT8(unblock_tile(world.map.tiles[i]),
+                                        unblock_tile(tiles[i]));
+            }
+        }
+    }
+
+    free(small_memory);
+    free(padded_memory);
+    free(legacy_memory);
+    free(padded);
+    free(legacy);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -554,6 +3026,73 @@ int main(void)
     RUN_TEST(test_fill_agent_fov_for_all_orientations);
 
     RUN_TEST(test_apply_occlusion_hides_occluded_tiles);
+    RUN_TEST(test_occlusion_mask_matches_boolean_cascade);
+
+    RUN_TEST(test_tick_batch_ticks_every_world);
+
+    RUN_TEST(test_random_word_has_independent_streams);
+    RUN_TEST(test_action_order_is_uniform_across_seeds);
+
+    RUN_TEST(test_load_world_with_padded_layout);
+    RUN_TEST(test_ahead_in_padded_map_does_not_check_bounds);
+    RUN_TEST(test_tick_on_padded_world_matches_legacy_world);
+
+    RUN_TEST(test_init_scratch_builds_bitboard);
+    RUN_TEST(test_tick_with_scratch_keeps_bitboard_in_sync);
+
+    RUN_TEST(test_update_agent_state_matches_scalar_fov);
+    RUN_TEST(test_tick_with_threads_matches_serial_tick);
+
+    RUN_TEST(test_tick_with_claim_table_resolves_conflicts_in_action_order);
+    RUN_TEST(test_tick_with_claim_table_blocks_occupied_targets);
+    RUN_TEST(test_tick_with_claim_table_does_not_depend_on_thread_count);
+
+    RUN_TEST(test_restore_world_undoes_ticks);
+    RUN_TEST(test_restore_world_reinitializes_scratch);
+    RUN_TEST(test_restore_world_rejects_snapshot_of_other_version);
+    RUN_TEST(test_restore_world_rejects_snapshot_of_other_size);
+
+    RUN_TEST(test_tick_fork_copies_written_chunks_only);
+    RUN_TEST(test_tick_fork_without_free_chunks_does_not_tick);
+    RUN_TEST(test_tick_fork_of_fork_leaves_parent_unchanged);
+
+    RUN_TEST(test_untick_reverts_ticks_in_reverse_order);
+    RUN_TEST(test_untick_without_scratch_reverts_doors);
+
+    RUN_TEST(test_tick_with_observation_cache_matches_tick);
+    RUN_TEST(test_tick_with_observation_cache_skips_unaffected_agents);
+
+    RUN_TEST(test_visible_agents_respects_occlusion);
+    RUN_TEST(test_visible_agents_without_agent_grid_finds_none);
+    RUN_TEST(test_agent_grid_follows_moves);
+    RUN_TEST(test_observe_shadowcast_reveals_open_map);
+    RUN_TEST(test_observe_shadowcast_casts_shadows);
+    RUN_TEST(test_observe_shadowcast_ignores_radius_out_of_range);
+    RUN_TEST(test_pack_tile_maps_tiles_to_packed_tiles);
+    RUN_TEST(test_tick_with_packed_states_matches_tick);
+    RUN_TEST(test_observation_planes_encode_tiles_by_channel);
+    RUN_TEST(test_frame_stack_keeps_latest_frames);
+    RUN_TEST(test_frame_stack_with_observation_cache_matches_tick);
+    RUN_TEST(test_frame_stack_with_packed_states_copies_skipped_agents);
+    RUN_TEST(test_frame_stack_of_other_states_is_not_ticked);
+    RUN_TEST(test_frame_stack_of_single_frame_keeps_skipped_agents);
+
+    RUN_TEST(test_generate_dungeon_connects_all_floor);
+    RUN_TEST(test_generate_dungeon_rejects_maps_without_room);
+    RUN_TEST(test_generate_dungeon_fills_small_map_with_agents);
+    RUN_TEST(test_generate_dungeon_depends_on_seed_only);
+
+    RUN_TEST(test_tick_batch_with_reset_restarts_done_worlds);
+    RUN_TEST(test_tick_batch_with_reset_keeps_flags_of_failed_resets);
+
+    RUN_TEST(test_distance_field_passes_agents_but_not_closed_doors);
+    RUN_TEST(test_distance_field_searches_match_reference);
+
+    RUN_TEST(test_next_path_actions_open_doors_on_the_way);
+    RUN_TEST(test_next_path_actions_search_again_after_edits_on_path);
+
+    RUN_TEST(test_update_exploration_remembers_visible_tiles);
+    RUN_TEST(test_update_exploration_keeps_last_seen_tiles_of_teams);
 
     return UNITY_END();
 }
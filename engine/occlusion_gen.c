@@ -0,0 +1,303 @@
+/* Generates the occlusion rules of an FoV with `size` rows and columns as a
+ * header for `engine.c`, e.g., `occlusion_gen 7 > occlusion_rules.h`.
+ *
+ * Tile `t` of the FoV is visible iff at least one of its rays passes through
+ * unblocked tiles only, where a ray is the set of tiles it crosses. The rays
+ * of `t` go from the center of the agent's tile to a sample point of `t`,
+ * i.e., its center and four points close to its corners, and are rasterized
+ * into the set of tiles whose interior they cross, excluding the tiles of the
+ * agent and `t`. Rays that cross all tiles of another ray of `t` are dropped
+ * because they never decide the visibility of `t`.
+ *
+ * The default FoV size keeps the hand-written rules of `occlusion_mask()` in
+ * `engine.c`, which are no straight lines, e.g., tile 1 is not hidden by tiles
+ * 6 or 7. Hence, `engine.c` uses the generated rules for other sizes only.
+ *
+ * The rules are emitted as straight-line code such that no tables are walked
+ * at run time.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MIN_FOV_SIZE 3
+#define MAX_FOV_SIZE 11
+#define MAX_TILES (MAX_FOV_SIZE * MAX_FOV_SIZE)
+#define BITS_PER_WORD 64
+#define MASK_WORDS ((MAX_TILES + BITS_PER_WORD - 1) / BITS_PER_WORD)
+#define N_SAMPLES 5
+
+/* Coordinates are scaled such that tiles span `TILE_SCALE` units and sample
+ * points are `CORNER_OFFSET` units away from the center of their tile along
+ * both axes.
+ */
+#define TILE_SCALE 20
+#define CORNER_OFFSET 9
+
+struct Ray
+{
+    uint32_t tile;
+    uint64_t mask[MASK_WORDS];
+};
+
+// time of a point on a segment as the fraction `num / den` with `den > 0`
+struct Time
+{
+    int64_t num;
+    int64_t den;
+};
+
+[[nodiscard]] static bool is_earlier(const struct Time lhs,
+                                     const struct Time rhs)
+{
+    return lhs.num * rhs.den < rhs.num * lhs.den;
+}
+
+/* Returns whether the segment from `(from_x, from_y)` to `(to_x, to_y)`
+ * crosses the interior of the tile at `row` and `col` by clipping the segment
+ * to the tile (Liang and Barsky, 1984). Segments that touch a corner or an
+ * edge only do not cross the tile.
+ */
+[[nodiscard]] static bool crosses_tile(
+    const int64_t from_x, // NOLINT(bugprone-easily-swappable-parameters)
+    const int64_t from_y,
+    const int64_t to_x,
+    const int64_t to_y,
+    const int64_t row,
+    const int64_t col)
+{
+    const int64_t left = col * TILE_SCALE;
+    const int64_t top = row * TILE_SCALE;
+    // the segment leaves each edge by `-steps[i]` and starts `gaps[i]` inside
+    const int64_t steps[4] = {
+        from_x - to_x, to_x - from_x, from_y - to_y, to_y - from_y};
+    const int64_t gaps[4] = {from_x - left,
+                             left + TILE_SCALE - from_x,
+                             from_y - top,
+                             top + TILE_SCALE - from_y};
+
+    struct Time enter = {.num = 0, .den = 1};
+    struct Time leave = {.num = 1, .den = 1};
+    for (int i = 0; i < 4; i++)
+    {
+        if (steps[i] == 0)
+        {
+            if (gaps[i] <= 0)
+            {
+                return false;
+            }
+        }
+        else if (steps[i] < 0)
+        {
+            const struct Time time = {.num = -gaps[i], .den = -steps[i]};
+            enter = is_earlier(enter, time) ? time : enter;
+        }
+        else
+        {
+            const struct Time time = {.num = gaps[i], .den = steps[i]};
+            leave = is_earlier(time, leave) ? time : leave;
+        }
+    }
+
+    return is_earlier(enter, leave);
+}
+
+[[nodiscard]] static struct Ray rasterize_ray(
+    const int size, // NOLINT(bugprone-easily-swappable-parameters)
+    const int tile,
+    const int64_t to_x, // NOLINT(bugprone-easily-swappable-parameters)
+    const int64_t to_y)
+{
+    const int self = (size * (size - 1)) + (size / 2);
+    const int64_t from_x = ((size / 2) * TILE_SCALE) + (TILE_SCALE / 2);
+    const int64_t from_y = ((size - 1) * TILE_SCALE) + (TILE_SCALE / 2);
+
+    struct Ray ray = {.tile = (uint32_t)tile};
+    for (int i = 0; i < size * size; i++)
+    {
+        if (i != self && i != tile
+            && crosses_tile(from_x, from_y, to_x, to_y, i / size, i % size))
+        {
+            ray.mask[i / BITS_PER_WORD] |= 1ULL << (i % BITS_PER_WORD);
+        }
+    }
+
+    return ray;
+}
+
+// returns whether `ray` crosses all tiles crossed by `other`
+[[nodiscard]] static bool covers(
+    const struct Ray *ray, // NOLINT(bugprone-easily-swappable-parameters)
+    const struct Ray *other)
+{
+    for (int i = 0; i < MASK_WORDS; i++)
+    {
+        if ((ray->mask[i] & other->mask[i]) != other->mask[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Appends the rays of `tile` to `rays` and returns their number, where rays
+ * that cover another ray are dropped, as are duplicates.
+ */
+static int add_tile_rays(
+    const int size, // NOLINT(bugprone-easily-swappable-parameters)
+    const int tile,
+    struct Ray *rays)
+{
+    const int64_t x_center = ((tile % size) * TILE_SCALE) + (TILE_SCALE / 2);
+    const int64_t y_center = ((tile / size) * TILE_SCALE) + (TILE_SCALE / 2);
+    const int64_t offsets[N_SAMPLES][2] = {
+        {0, 0},
+        {-CORNER_OFFSET, -CORNER_OFFSET},
+        {CORNER_OFFSET, -CORNER_OFFSET},
+        {-CORNER_OFFSET, CORNER_OFFSET},
+        {CORNER_OFFSET, CORNER_OFFSET},
+    };
+
+    struct Ray candidates[N_SAMPLES];
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        candidates[i] = rasterize_ray(size,
+                                      tile,
+                                      x_center + offsets[i][0],
+                                      y_center + offsets[i][1]);
+    }
+
+    int n_rays = 0;
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        bool is_redundant = false;
+        for (int j = 0; j < N_SAMPLES && !is_redundant; j++)
+        {
+            // of two equal rays, the first one is kept
+            is_redundant = j != i && covers(&candidates[i], &candidates[j])
+                && (j < i || !covers(&candidates[j], &candidates[i]));
+        }
+
+        if (!is_redundant)
+        {
+            rays[n_rays++] = candidates[i];
+        }
+    }
+
+    return n_rays;
+}
+
+// returns whether `ray` crosses no tiles
+[[nodiscard]] static bool is_empty(const struct Ray *ray)
+{
+    for (int i = 0; i < MASK_WORDS; i++)
+    {
+        if (ray->mask[i] != 0U)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// prints the condition that `ray` crosses a blocked tile
+static void print_crossed(const struct Ray *ray, const int n_words)
+{
+    int n_terms = 0;
+    for (int i = 0; i < n_words; i++)
+    {
+        n_terms += (ray->mask[i] != 0U) ? 1 : 0;
+    }
+
+    printf((n_terms == 1) ? "(" : "((");
+    for (int i = 0, j = 0; i < n_words; i++)
+    {
+        if (ray->mask[i] != 0U)
+        {
+            printf("%s(blocked[%d] & 0x%016llXULL)",
+                   (j++ == 0) ? "" : " | ",
+                   i,
+                   (unsigned long long)ray->mask[i]);
+        }
+    }
+    printf((n_terms == 1) ? " != 0U)" : ") != 0U)");
+}
+
+int main(const int argc, char **argv)
+{
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    const long arg = (argc == 2) ? strtol(argv[1], nullptr, 10) : 0;
+    if (arg < MIN_FOV_SIZE || arg > MAX_FOV_SIZE || arg % 2 == 0)
+    {
+        (void)fprintf(stderr,
+                      "usage: %s <size>, where size is an odd number "
+                      "in [%d, %d]\n",
+                      argv[0],
+                      MIN_FOV_SIZE,
+                      MAX_FOV_SIZE);
+        return EXIT_FAILURE;
+    }
+
+    const int size = (int)arg;
+    const int self = (size * (size - 1)) + (size / 2);
+    const int n_words = ((size * size) + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+    static struct Ray rays[MAX_TILES * N_SAMPLES];
+    int n_rays = 0;
+    for (int tile = 0; tile < size * size; tile++)
+    {
+        if (tile != self)
+        {
+            n_rays += add_tile_rays(size, tile, rays + n_rays);
+        }
+    }
+
+    printf("// generated by `occlusion_gen %d`, do not edit\n\n", size);
+    printf("#define OCCLUSION_FOV_SIZE %dU\n", size);
+    printf("#define OCCLUSION_MASK_WORDS %dU\n\n", n_words);
+
+    printf("/* Stores the mask of hidden tiles in `hidden` given the mask of "
+           "blocked tiles,\n");
+    printf(" * where bit `i %% 64` of word `i / 64` refers to tile `i`.\n");
+    printf(" */\n");
+    printf("// NOLINTBEGIN(readability-magic-numbers)\n");
+    printf("static void occlusion_hidden(const uint64_t *blocked, "
+           "uint64_t *hidden)\n");
+    printf("{\n");
+    for (int i = 0; i < n_words; i++)
+    {
+        printf("    hidden[%d] = 0U;\n", i);
+    }
+
+    // rays of a tile are adjacent, and tiles with an empty ray are visible
+    for (int i = 0; i < n_rays;)
+    {
+        int end = i;
+        bool is_visible = false;
+        for (; end < n_rays && rays[end].tile == rays[i].tile; end++)
+        {
+            is_visible = is_visible || is_empty(&rays[end]);
+        }
+
+        if (!is_visible)
+        {
+            printf("\n    // tile %u\n", rays[i].tile);
+            printf("    hidden[%u] |= (uint64_t)(",
+                   rays[i].tile / BITS_PER_WORD);
+            for (int j = i; j < end; j++)
+            {
+                printf("%s", (j == i) ? "" : "\n        && ");
+                print_crossed(&rays[j], n_words);
+            }
+            printf(")\n        << %uU;\n", rays[i].tile % BITS_PER_WORD);
+        }
+
+        i = end;
+    }
+    printf("}\n");
+    printf("// NOLINTEND(readability-magic-numbers)\n");
+
+    return EXIT_SUCCESS;
+}
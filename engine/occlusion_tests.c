@@ -0,0 +1,243 @@
+#include "engine.c"
+
+#include "unity.h"
+
+enum : uint32_t
+{
+    n_tiles = FOV_SIZE * FOV_SIZE,
+    agent_row = FOV_SIZE - 1U,
+    agent_col = FOV_SIZE / 2U
+};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void fill_fov(enum Tile *tiles, const enum Tile tile)
+{
+    for (uint32_t i = 0; i < n_tiles; i++)
+    {
+        tiles[i] = tile;
+    }
+}
+
+void test_apply_occlusion_keeps_open_fov_visible(void)
+{
+    enum Tile tiles[n_tiles];
+    fill_fov(tiles, TILE_FLOOR);
+
+    apply_occlusion(tiles);
+
+    for (uint32_t i = 0; i < n_tiles; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[i]);
+    }
+}
+
+void test_apply_occlusion_hides_tiles_behind_wall_ahead(void)
+{
+    enum Tile tiles[n_tiles];
+    fill_fov(tiles, TILE_FLOOR);
+    tiles[FOV_SELF_IDX - FOV_SIZE] = TILE_WALL;
+
+    apply_occlusion(tiles);
+
+    for (uint32_t row = 0; row + 2U < FOV_SIZE; row++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN,
+                                tiles[(row * FOV_SIZE) + agent_col]);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[FOV_SELF_IDX - 1U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[FOV_SELF_IDX + 1U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[FOV_SELF_IDX - FOV_SIZE - 1U]);
+    TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[FOV_SELF_IDX - FOV_SIZE + 1U]);
+}
+
+void test_apply_occlusion_hides_tiles_behind_row_of_walls(void)
+{
+    enum Tile tiles[n_tiles];
+    fill_fov(tiles, TILE_FLOOR);
+    for (uint32_t col = 0; col < FOV_SIZE; col++)
+    {
+        tiles[((agent_row - 1U) * FOV_SIZE) + col] = TILE_WALL;
+    }
+
+    apply_occlusion(tiles);
+
+    for (uint32_t i = 0; i < (agent_row - 1U) * FOV_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, tiles[i]);
+    }
+
+    for (uint32_t i = agent_row * FOV_SIZE; i < n_tiles; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(TILE_FLOOR, tiles[i]);
+    }
+}
+
+void test_apply_occlusion_is_mirror_symmetric(void)
+{
+    for (uint32_t n = 0; n < 1000U; n++)
+    {
+        enum Tile tiles[n_tiles];
+        enum Tile mirrored[n_tiles];
+        for (uint32_t i = 0; i < n_tiles; i++)
+        {
+            const uint32_t row = i / FOV_SIZE;
+            const uint32_t col = i % FOV_SIZE;
+            const uint32_t hash = ((n * n_tiles) + i) * 2654435761U;
+            const enum Tile tile =
+                (hash >> 30U == 0U) ? TILE_WALL : TILE_FLOOR;
+
+            tiles[i] = (i == FOV_SELF_IDX) ? TILE_FLOOR_OCCUPIED : tile;
+            mirrored[(row * FOV_SIZE) + (FOV_SIZE - 1U - col)] = tiles[i];
+        }
+
+        apply_occlusion(tiles);
+        apply_occlusion(mirrored);
+
+        for (uint32_t i = 0; i < n_tiles; i++)
+        {
+            const uint32_t row = i / FOV_SIZE;
+            const uint32_t col = i % FOV_SIZE;
+            TEST_ASSERT_EQUAL_UINT8(
+                tiles[i], mirrored[(row * FOV_SIZE) + (FOV_SIZE - 1U - col)]);
+        }
+    }
+}
+
+void test_bitboard_fov_matches_tile_fov(void)
+{
+    enum : uint32_t
+    {
+        n_rows = 16U,
+        n_cols = 16U,
+        n_agents = 16U,
+        n_words = 3U + (2U * n_agents) + ((n_rows * n_cols) / 4U),
+    };
+
+    // agents on the diagonal, surrounded by hashed walls and doors
+    uint32_t world_state[n_words] = {n_agents};
+    world_state[1U + (2U * n_agents)] = n_rows;
+    world_state[2U + (2U * n_agents)] = n_cols;
+    enum Tile *map = (enum Tile *)(world_state + 3U + (2U * n_agents));
+    for (uint32_t i = 0; i < n_rows * n_cols; i++)
+    {
+        const uint32_t hash = i * 2654435761U;
+        map[i] = (hash >> 30U == 0U) ? TILE_WALL
+            : (hash >> 29U == 2U)    ? TILE_CLOSED_DOOR
+                                     : TILE_FLOOR;
+    }
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        world_state[1U + i] = i * (n_cols + 1U);
+        world_state[1U + n_agents + i] = i % 4U;
+        map[i * (n_cols + 1U)] = TILE_FLOOR_OCCUPIED;
+    }
+
+    uint64_t scratch[4096] = {};
+    TEST_ASSERT_LESS_OR_EQUAL_size_t(
+        4096U, scratch_size(world_state, SCRATCH_BITBOARD));
+    init_scratch(world_state, scratch, SCRATCH_BITBOARD);
+
+    const struct World world = load_world(world_state, 0U);
+    struct World bitboard_world = load_world(world_state, 0U);
+    attach_scratch(&bitboard_world, scratch);
+    for (uint32_t i = 0; i < n_agents; i++)
+    {
+        enum Tile expected[n_tiles];
+        fill_agent_fov(&world, i, expected);
+        apply_occlusion(expected);
+
+        enum Tile tiles[n_tiles];
+        fill_occluded_fov(&bitboard_world, i, tiles);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, tiles, n_tiles);
+    }
+}
+
+// squared distance of the center of tile `i` from the center of the agent
+[[nodiscard]] static uint32_t distance_from_agent(const uint32_t i)
+{
+    const uint32_t ahead = agent_row - (i / FOV_SIZE);
+    const uint32_t aside = (i % FOV_SIZE > agent_col)
+        ? (i % FOV_SIZE) - agent_col
+        : agent_col - (i % FOV_SIZE);
+    return (ahead * ahead) + (aside * aside);
+}
+
+void test_apply_occlusion_hides_tiles_behind_blocked_tile_only(void)
+{
+    for (uint32_t wall = 0; wall < n_tiles; wall++)
+    {
+        if (wall == FOV_SELF_IDX)
+        {
+            continue;
+        }
+
+        enum Tile tiles[n_tiles];
+        fill_fov(tiles, TILE_FLOOR);
+        tiles[FOV_SELF_IDX] = TILE_FLOOR_OCCUPIED;
+        tiles[wall] = TILE_WALL;
+
+        apply_occlusion(tiles);
+
+        for (uint32_t i = 0; i < n_tiles; i++)
+        {
+            if (tiles[i] == TILE_HIDDEN)
+            {
+                TEST_ASSERT_GREATER_OR_EQUAL_UINT32(distance_from_agent(wall),
+                                                    distance_from_agent(i));
+            }
+        }
+    }
+}
+
+void test_apply_occlusion_never_reveals_tiles_behind_more_walls(void)
+{
+    for (uint32_t n = 0; n < 1000U; n++)
+    {
+        enum Tile tiles[n_tiles];
+        for (uint32_t i = 0; i < n_tiles; i++)
+        {
+            const uint32_t hash = ((n * n_tiles) + i) * 2654435761U;
+            tiles[i] = (hash >> 29U == 0U) ? TILE_WALL : TILE_FLOOR;
+        }
+        tiles[FOV_SELF_IDX] = TILE_FLOOR_OCCUPIED;
+
+        // one more wall on a floor tile
+        const uint32_t extra = (n * 7U) % n_tiles;
+        enum Tile walled[n_tiles];
+        for (uint32_t i = 0; i < n_tiles; i++)
+        {
+            walled[i] = (i == extra && tiles[i] == TILE_FLOOR) ? TILE_WALL
+                                                                : tiles[i];
+        }
+
+        apply_occlusion(tiles);
+        apply_occlusion(walled);
+
+        for (uint32_t i = 0; i < n_tiles; i++)
+        {
+            if (tiles[i] == TILE_HIDDEN)
+            {
+                TEST_ASSERT_EQUAL_UINT8(TILE_HIDDEN, walled[i]);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_apply_occlusion_keeps_open_fov_visible);
+    RUN_TEST(test_apply_occlusion_hides_tiles_behind_wall_ahead);
+    RUN_TEST(test_apply_occlusion_hides_tiles_behind_row_of_walls);
+    RUN_TEST(test_apply_occlusion_is_mirror_symmetric);
+    RUN_TEST(test_apply_occlusion_hides_tiles_behind_blocked_tile_only);
+    RUN_TEST(test_apply_occlusion_never_reveals_tiles_behind_more_walls);
+    RUN_TEST(test_bitboard_fov_matches_tile_fov);
+
+    return UNITY_END();
+}
@@ -0,0 +1,214 @@
+/* Portable emulation of the subset of `wasm_simd128.h` used by `engine.c`,
+ * which lets the unit tests run the SIMD code paths natively, e.g., `make
+ * build/unit_tests_simd`. Lanes are stored in little-endian order as in wasm.
+ */
+#ifndef WASM_SIMD128_EMULATION_H
+#define WASM_SIMD128_EMULATION_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint8_t bytes[16];
+} v128_t;
+
+static inline void emulated_copy(void *dst, const void *src, const uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        ((uint8_t *)dst)[i] = ((const uint8_t *)src)[i];
+    }
+}
+
+static inline v128_t wasm_v128_load(const void *mem)
+{
+    v128_t v;
+    emulated_copy(v.bytes, mem, 16U);
+    return v;
+}
+
+static inline void wasm_v128_store(void *mem, const v128_t a)
+{
+    emulated_copy(mem, a.bytes, 16U);
+}
+
+static inline v128_t
+wasm_v128_load8_lane(const void *mem, v128_t vec, const int lane)
+{
+    emulated_copy(vec.bytes + lane, mem, 1U);
+    return vec;
+}
+
+static inline v128_t
+wasm_v128_load32_lane(const void *mem, v128_t vec, const int lane)
+{
+    emulated_copy(vec.bytes + (4 * lane), mem, 4U);
+    return vec;
+}
+
+static inline void
+wasm_v128_store8_lane(void *mem, const v128_t vec, const int lane)
+{
+    emulated_copy(mem, vec.bytes + lane, 1U);
+}
+
+static inline void
+wasm_v128_store64_lane(void *mem, const v128_t vec, const int lane)
+{
+    emulated_copy(mem, vec.bytes + (8 * lane), 8U);
+}
+
+static inline v128_t emulated_bytes(const uint8_t *bytes)
+{
+    return wasm_v128_load(bytes);
+}
+
+#define wasm_u8x16_const(...) emulated_bytes((const uint8_t[16]){__VA_ARGS__})
+
+static inline v128_t wasm_i64x2_const(const int64_t a, const int64_t b)
+{
+    const int64_t lanes[2] = {a, b};
+    return wasm_v128_load(lanes);
+}
+
+static inline v128_t wasm_u8x16_splat(const uint8_t a)
+{
+    v128_t v;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        v.bytes[i] = a;
+    }
+    return v;
+}
+
+static inline v128_t wasm_u16x8_splat(const uint16_t a)
+{
+    const uint16_t lanes[8] = {a, a, a, a, a, a, a, a};
+    return wasm_v128_load(lanes);
+}
+
+static inline v128_t wasm_f32x4_splat(const float a)
+{
+    const float lanes[4] = {a, a, a, a};
+    return wasm_v128_load(lanes);
+}
+
+static inline v128_t wasm_v128_and(const v128_t a, const v128_t b)
+{
+    v128_t v;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        v.bytes[i] = a.bytes[i] & b.bytes[i];
+    }
+    return v;
+}
+
+static inline v128_t wasm_v128_or(const v128_t a, const v128_t b)
+{
+    v128_t v;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        v.bytes[i] = a.bytes[i] | b.bytes[i];
+    }
+    return v;
+}
+
+static inline v128_t wasm_v128_andnot(const v128_t a, const v128_t b)
+{
+    v128_t v;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        v.bytes[i] = a.bytes[i] & (uint8_t)~b.bytes[i];
+    }
+    return v;
+}
+
+static inline v128_t wasm_i8x16_eq(const v128_t a, const v128_t b)
+{
+    v128_t v;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        v.bytes[i] = (a.bytes[i] == b.bytes[i]) ? 0xFFU : 0U;
+    }
+    return v;
+}
+
+static inline int32_t wasm_i8x16_bitmask(const v128_t a)
+{
+    int32_t mask = 0;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        mask |= (int32_t)(a.bytes[i] >> 7U) << i;
+    }
+    return mask;
+}
+
+static inline v128_t wasm_i8x16_swizzle(const v128_t a, const v128_t b)
+{
+    v128_t v;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        v.bytes[i] = (b.bytes[i] < 16U) ? a.bytes[b.bytes[i]] : 0U;
+    }
+    return v;
+}
+
+static inline v128_t
+emulated_shuffle(const v128_t a, const v128_t b, const uint8_t *lanes)
+{
+    v128_t v;
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        v.bytes[i] = (lanes[i] < 16U) ? a.bytes[lanes[i]]
+                                      : b.bytes[lanes[i] - 16U];
+    }
+    return v;
+}
+
+#define wasm_i8x16_shuffle(a, b, ...)                                          \
+    emulated_shuffle((a), (b), (const uint8_t[16]){__VA_ARGS__})
+
+static inline v128_t emulated_extend_i8x16(const v128_t a, const uint32_t half)
+{
+    int16_t lanes[8];
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        lanes[i] = (int8_t)a.bytes[(8U * half) + i];
+    }
+    return wasm_v128_load(lanes);
+}
+
+static inline v128_t wasm_i16x8_extend_low_i8x16(const v128_t a)
+{
+    return emulated_extend_i8x16(a, 0U);
+}
+
+static inline v128_t wasm_i16x8_extend_high_i8x16(const v128_t a)
+{
+    return emulated_extend_i8x16(a, 1U);
+}
+
+static inline v128_t emulated_extend_i16x8(const v128_t a, const uint32_t half)
+{
+    int16_t halves[8];
+    emulated_copy(halves, a.bytes, 16U);
+
+    int32_t lanes[4];
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        lanes[i] = halves[(4U * half) + i];
+    }
+    return wasm_v128_load(lanes);
+}
+
+static inline v128_t wasm_i32x4_extend_low_i16x8(const v128_t a)
+{
+    return emulated_extend_i16x8(a, 0U);
+}
+
+static inline v128_t wasm_i32x4_extend_high_i16x8(const v128_t a)
+{
+    return emulated_extend_i16x8(a, 1U);
+}
+
+#endif